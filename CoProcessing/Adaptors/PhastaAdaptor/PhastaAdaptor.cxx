@@ -133,14 +133,9 @@ extern "C" void addfields(int* nshg, int* vtkNotUsed(ndof), double* dofArray, in
   // velocity
   if (idd->IsFieldNeeded("velocity"))
   {
-    vtkDoubleArray* velocity = vtkDoubleArray::New();
+    vtkDataArray* velocity =
+      vtkCPAdaptorAPI::NewArrayFromFortran(VTK_DOUBLE, dofArray, NumberOfNodes, 3, *nshg);
     velocity->SetName("velocity");
-    velocity->SetNumberOfComponents(3);
-    velocity->SetNumberOfTuples(NumberOfNodes);
-    for (vtkIdType idx = 0; idx < NumberOfNodes; idx++)
-    {
-      velocity->SetTuple3(idx, dofArray[idx], dofArray[idx + *nshg], dofArray[idx + *nshg * 2]);
-    }
     UnstructuredGrid->GetPointData()->AddArray(velocity);
     velocity->Delete();
   }
@@ -0,0 +1,199 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestAsynchronousCoProcessing.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that asynchronous co-processing executes the pipelines in another
+// thread on a copy of the simulation data, returns the result of the
+// previous time step and processes every time step, and that it falls back
+// to synchronous co-processing for pipelines that cannot execute
+// asynchronously.
+
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPPipeline.h"
+#include "vtkCPProcessor.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+
+#include <vector>
+
+namespace
+{
+// Records the value of the "step" array and the thread of every execution.
+class vtkTestPipeline : public vtkCPPipeline
+{
+public:
+  static vtkTestPipeline* New();
+  vtkTypeMacro(vtkTestPipeline, vtkCPPipeline);
+
+  int RequestDataDescription(vtkCPDataDescription* dataDescription) VTK_OVERRIDE
+  {
+    vtkCPInputDataDescription* input = dataDescription->GetInputDescriptionByName("input");
+    if (!input)
+    {
+      return 0;
+    }
+    input->AllFieldsOn();
+    input->GenerateMeshOn();
+    return 1;
+  }
+
+  int CoProcess(vtkCPDataDescription* dataDescription) VTK_OVERRIDE
+  {
+    vtkImageData* grid = vtkImageData::SafeDownCast(
+      dataDescription->GetInputDescriptionByName("input")->GetGrid());
+    vtkDataArray* array = grid ? grid->GetPointData()->GetArray("step") : NULL;
+    this->Steps.push_back(array ? static_cast<int>(array->GetTuple1(0)) : -1);
+    this->InMainThread.push_back(
+      vtkMultiThreader::ThreadsEqual(vtkMultiThreader::GetCurrentThreadID(), this->MainThread) !=
+      0);
+    // Fail on the step given by FailingStep to check the returned results.
+    return dataDescription->GetTimeStep() == this->FailingStep ? 0 : 1;
+  }
+
+  bool CanExecuteAsynchronously() VTK_OVERRIDE { return this->Asynchronous; }
+
+  std::vector<int> Steps;
+  std::vector<bool> InMainThread;
+  vtkMultiThreaderIDType MainThread;
+  vtkIdType FailingStep;
+  bool Asynchronous;
+
+protected:
+  vtkTestPipeline()
+    : MainThread(vtkMultiThreader::GetCurrentThreadID())
+    , FailingStep(-1)
+    , Asynchronous(true)
+  {
+  }
+  ~vtkTestPipeline() override {}
+
+private:
+  vtkTestPipeline(const vtkTestPipeline&) = delete;
+  void operator=(const vtkTestPipeline&) = delete;
+};
+
+vtkStandardNewMacro(vtkTestPipeline);
+
+const int NumberOfTimeSteps = 10;
+
+// Co-processes NumberOfTimeSteps time steps, overwriting the simulation data
+// as soon as CoProcess() returns. Returns false if a result of CoProcess()
+// is not the expected one.
+bool Run(vtkCPProcessor* processor, bool asynchronous)
+{
+  vtkNew<vtkImageData> grid;
+  grid->SetDimensions(2, 2, 2);
+  vtkNew<vtkDoubleArray> array;
+  array->SetName("step");
+  array->SetNumberOfTuples(grid->GetNumberOfPoints());
+  grid->GetPointData()->AddArray(array.Get());
+
+  vtkNew<vtkCPDataDescription> dataDescription;
+  dataDescription->AddInput("input");
+
+  for (int step = 0; step < NumberOfTimeSteps; step++)
+  {
+    dataDescription->SetTimeData(step, step);
+    if (!processor->RequestDataDescription(dataDescription.Get()))
+    {
+      cerr << "No co-processing requested for time step " << step << "." << endl;
+      return false;
+    }
+    array->FillComponent(0, step);
+    dataDescription->GetInputDescriptionByName("input")->SetGrid(grid.Get());
+    int result = processor->CoProcess(dataDescription.Get());
+    array->FillComponent(0, -1);
+
+    // time step 2 fails: asynchronously, this is reported for time step 3.
+    int failingStep = asynchronous ? 3 : 2;
+    if (result != (step == failingStep ? 0 : 1))
+    {
+      cerr << "CoProcess() returned " << result << " for time step " << step << "." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Check(vtkTestPipeline* pipeline, bool inMainThread)
+{
+  if (static_cast<int>(pipeline->Steps.size()) != NumberOfTimeSteps)
+  {
+    cerr << "Executed " << pipeline->Steps.size() << " time steps instead of "
+         << NumberOfTimeSteps << "." << endl;
+    return false;
+  }
+  for (int step = 0; step < NumberOfTimeSteps; step++)
+  {
+    if (pipeline->Steps[step] != step)
+    {
+      cerr << "Time step " << step << " saw the data of time step " << pipeline->Steps[step]
+           << "." << endl;
+      return false;
+    }
+    if (pipeline->InMainThread[step] != inMainThread)
+    {
+      cerr << "Time step " << step << " was executed in the "
+           << (inMainThread ? "analysis" : "main") << " thread." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestAsynchronousCoProcessing(int, char* [])
+{
+  vtkNew<vtkTestPipeline> pipeline;
+  pipeline->FailingStep = 2;
+  vtkNew<vtkCPProcessor> processor;
+  processor->AsynchronousOn();
+  processor->AddPipeline(pipeline.Get());
+  if (!Run(processor.Get(), true))
+  {
+    return EXIT_FAILURE;
+  }
+  // the last time step is processed by Finalize().
+  processor->Finalize();
+  if (!Check(pipeline.Get(), false))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // a pipeline that cannot execute asynchronously makes the processor
+  // execute all its pipelines synchronously, with a warning.
+  vtkNew<vtkTestPipeline> synchronousPipeline;
+  synchronousPipeline->FailingStep = 2;
+  synchronousPipeline->Asynchronous = false;
+  vtkNew<vtkTestPipeline> otherPipeline;
+  otherPipeline->FailingStep = 2;
+  vtkNew<vtkCPProcessor> fallbackProcessor;
+  fallbackProcessor->AsynchronousOn();
+  fallbackProcessor->AddPipeline(synchronousPipeline.Get());
+  fallbackProcessor->AddPipeline(otherPipeline.Get());
+  vtkObject::GlobalWarningDisplayOff();
+  bool success = Run(fallbackProcessor.Get(), false);
+  vtkObject::GlobalWarningDisplayOn();
+  fallbackProcessor->Finalize();
+  if (!success || !Check(synchronousPipeline.Get(), true) || !Check(otherPipeline.Get(), true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
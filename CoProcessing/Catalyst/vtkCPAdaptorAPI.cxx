@@ -22,8 +22,10 @@
 #include "vtkDataSet.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkPointData.h"
+#include "vtkSOADataArrayTemplate.h"
 
 #include <iostream>
+#include <vector>
 
 // This code is meant as an API for Fortran and C simulation codes.
 namespace ParaViewCoProcessing
@@ -40,6 +42,21 @@ void ClearFieldDataFromGrid(vtkDataSet* grid)
     grid->GetFieldData()->Initialize();
   }
 }
+
+/// Create an array that uses the per-component arrays of the simulation.
+template <typename ValueType>
+vtkDataArray* NewSOAArray(
+  void* const* components, vtkIdType numberOfTuples, int numberOfComponents)
+{
+  vtkSOADataArrayTemplate<ValueType>* array = vtkSOADataArrayTemplate<ValueType>::New();
+  array->SetNumberOfComponents(numberOfComponents);
+  for (int i = 0; i < numberOfComponents; i++)
+  {
+    array->SetArray(i, static_cast<ValueType*>(components[i]), numberOfTuples,
+      /*updateMaxId=*/true, /*save=*/true);
+  }
+  return array;
+}
 } // end namespace
 
 vtkCPDataDescription* vtkCPAdaptorAPI::CoProcessorData = NULL;
@@ -164,3 +181,52 @@ void vtkCPAdaptorAPI::CoProcess()
   // Reset time data.
   vtkCPAdaptorAPI::IsTimeDataSet = false;
 }
+
+//-----------------------------------------------------------------------------
+vtkDataArray* vtkCPAdaptorAPI::NewArrayFromAOS(
+  int dataType, void* data, vtkIdType numberOfTuples, int numberOfComponents)
+{
+  vtkDataArray* array = vtkDataArray::CreateDataArray(dataType);
+  if (!array)
+  {
+    vtkGenericWarningMacro("Unsupported data type " << dataType << ".");
+    return NULL;
+  }
+  array->SetNumberOfComponents(numberOfComponents);
+  // save = 1 so that the array never frees the simulation's memory
+  array->SetVoidArray(data, numberOfTuples * numberOfComponents, 1);
+  return array;
+}
+
+//-----------------------------------------------------------------------------
+vtkDataArray* vtkCPAdaptorAPI::NewArrayFromSOA(
+  int dataType, void* const* components, vtkIdType numberOfTuples, int numberOfComponents)
+{
+  if (numberOfComponents == 1)
+  {
+    return vtkCPAdaptorAPI::NewArrayFromAOS(dataType, components[0], numberOfTuples, 1);
+  }
+  switch (dataType)
+  {
+    vtkTemplateMacro(return ParaViewCoProcessing::NewSOAArray<VTK_TT>(
+                       components, numberOfTuples, numberOfComponents));
+    default:
+      vtkGenericWarningMacro("Unsupported data type " << dataType << ".");
+  }
+  return NULL;
+}
+
+//-----------------------------------------------------------------------------
+vtkDataArray* vtkCPAdaptorAPI::NewArrayFromFortran(int dataType, void* data,
+  vtkIdType numberOfTuples, int numberOfComponents, vtkIdType leadingDimension)
+{
+  // each column of the Fortran array is a contiguous component
+  std::vector<void*> components(numberOfComponents);
+  vtkIdType columnSize = leadingDimension * vtkDataArray::GetDataTypeSize(dataType);
+  for (int i = 0; i < numberOfComponents; i++)
+  {
+    components[i] = static_cast<char*>(data) + i * columnSize;
+  }
+  return vtkCPAdaptorAPI::NewArrayFromSOA(
+    dataType, &components[0], numberOfTuples, numberOfComponents);
+}
@@ -20,6 +20,7 @@
 
 class vtkCPDataDescription;
 class vtkCPProcessor;
+class vtkDataArray;
 class vtkDataSet;
 
 /// vtkCPAdaptorAPI provides the implementation for API exposed to typical
@@ -54,6 +55,30 @@ public:
   /// provides access to the vtkCPProcessor instance.
   static vtkCPProcessor* GetCoProcessor() { return vtkCPAdaptorAPI::CoProcessor; }
 
+#ifndef __WRAP__
+  /// Helpers to use arrays owned by the simulation as VTK arrays without
+  /// copying them. The returned array must be released with Delete() but
+  /// the memory stays owned by the simulation and must remain valid while
+  /// the array is in use. The grid can thus be built once, with only the
+  /// field arrays wrapped again each time step (see NeedToCreateGrid()).
+  /// dataType is a VTK type such as VTK_FLOAT or VTK_DOUBLE, so coordinates
+  /// and fields can have different precisions. These return NULL if
+  /// dataType is not supported.
+
+  /// Wraps an array of interleaved tuples (x0 y0 z0 x1 y1 z1 ...).
+  static vtkDataArray* NewArrayFromAOS(
+    int dataType, void* data, vtkIdType numberOfTuples, int numberOfComponents);
+
+  /// Wraps one contiguous array per component (x0 x1 ... y0 y1 ...).
+  static vtkDataArray* NewArrayFromSOA(
+    int dataType, void* const* components, vtkIdType numberOfTuples, int numberOfComponents);
+
+  /// Wraps a Fortran array of shape (leadingDimension, numberOfComponents)
+  /// where only the first numberOfTuples rows are used.
+  static vtkDataArray* NewArrayFromFortran(int dataType, void* data, vtkIdType numberOfTuples,
+    int numberOfComponents, vtkIdType leadingDimension);
+#endif
+
 protected:
   static vtkCPDataDescription* CoProcessorData;
   static vtkCPProcessor* CoProcessor;
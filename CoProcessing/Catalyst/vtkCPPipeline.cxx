@@ -30,6 +30,12 @@ int vtkCPPipeline::Finalize()
   return 1;
 }
 
+//----------------------------------------------------------------------------
+bool vtkCPPipeline::CanExecuteAsynchronously()
+{
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkCPPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -48,6 +48,11 @@ public:
   /// is given. Returns 1 for success and 0 for failure.
   virtual int Finalize();
 
+  /// Returns true if the pipeline can execute in the analysis thread of a
+  /// vtkCPProcessor in asynchronous mode, i.e. in a thread other than the
+  /// one that created it. Default returns true.
+  virtual bool CanExecuteAsynchronously();
+
 protected:
   vtkCPPipeline();
   virtual ~vtkCPPipeline();
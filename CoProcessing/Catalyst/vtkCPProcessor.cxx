@@ -25,7 +25,13 @@
 #include "vtkMPICommunicator.h"
 #include "vtkMPIController.h"
 #endif
+#include "vtkConditionVariable.h"
+#include "vtkDataObject.h"
+#include "vtkFieldData.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkSMIntVectorProperty.h"
 #include "vtkSMProxy.h"
@@ -40,8 +46,208 @@ struct vtkCPProcessorInternals
   typedef std::list<vtkSmartPointer<vtkCPPipeline> > PipelineList;
   typedef PipelineList::iterator PipelineListIterator;
   PipelineList Pipelines;
+
+  // Asynchronous co-processing: the simulation thread stages a copy of the
+  // data description and the analysis thread executes the pipelines on it.
+  // Lock protects StagedDescription, LastResult and Terminate.
+  vtkNew<vtkMultiThreader> Threader;
+  int ThreadId;
+  vtkSimpleMutexLock Lock;
+  vtkSimpleConditionVariable Condition;
+  vtkSmartPointer<vtkCPDataDescription> StagedDescription;
+  int LastResult;
+  bool Terminate;
+  bool WarnedSynchronous;
+
+  // While the analysis thread runs, the pipelines use a controller on a
+  // duplicate of the global controller's communicator so that their
+  // collectives never interleave with the simulation's MPI calls.
+  vtkSmartPointer<vtkMultiProcessController> AnalysisController;
+  vtkMultiProcessController* SimulationController;
+
+  vtkCPProcessorInternals()
+    : ThreadId(-1)
+    , LastResult(1)
+    , Terminate(false)
+    , WarnedSynchronous(false)
+    , SimulationController(NULL)
+  {
+  }
+
+  static VTK_THREAD_RETURN_TYPE AnalysisThread(void* arg)
+  {
+    vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkCPProcessor* self = static_cast<vtkCPProcessor*>(info->UserData);
+    vtkCPProcessorInternals* internal = self->Internal;
+    internal->Lock.Lock();
+    for (;;)
+    {
+      while (!internal->StagedDescription && !internal->Terminate)
+      {
+        internal->Condition.Wait(internal->Lock);
+      }
+      if (!internal->StagedDescription)
+      {
+        break;
+      }
+      vtkCPDataDescription* dataDescription = internal->StagedDescription;
+      internal->Lock.Unlock();
+      int success = self->ExecutePipelines(dataDescription);
+      internal->Lock.Lock();
+      internal->LastResult = success;
+      internal->StagedDescription = NULL;
+      internal->Condition.Broadcast();
+    }
+    internal->Lock.Unlock();
+    return VTK_THREAD_RETURN_VALUE;
+  }
+
+  // Starts the analysis thread if it is not running yet.
+  void StartAnalysisThread(vtkCPProcessor* self)
+  {
+    if (this->ThreadId < 0)
+    {
+      this->UseAnalysisController();
+      this->Terminate = false;
+      this->ThreadId = this->Threader->SpawnThread(&vtkCPProcessorInternals::AnalysisThread, self);
+    }
+  }
+
+  // Makes a controller on a duplicate of the global controller's
+  // communicator the global controller. Collective over the processes of the
+  // global controller.
+  void UseAnalysisController()
+  {
+#ifdef PARAVIEW_USE_MPI
+    vtkMultiProcessController* global = vtkMultiProcessController::GetGlobalController();
+    vtkMPICommunicator* communicator =
+      global ? vtkMPICommunicator::SafeDownCast(global->GetCommunicator()) : NULL;
+    if (communicator)
+    {
+      vtkNew<vtkMPICommunicator> duplicate;
+      duplicate->Duplicate(communicator);
+      vtkMPIController* controller = vtkMPIController::New();
+      controller->SetCommunicator(duplicate.Get());
+      this->AnalysisController.TakeReference(controller);
+      this->SimulationController = global;
+      vtkMultiProcessController::SetGlobalController(controller);
+    }
+#endif
+  }
+
+  // Restores the global controller replaced by UseAnalysisController().
+  void ReleaseAnalysisController()
+  {
+    if (this->AnalysisController)
+    {
+      vtkMultiProcessController::SetGlobalController(this->SimulationController);
+      this->AnalysisController = NULL;
+      this->SimulationController = NULL;
+    }
+  }
+
+  // Waits for the staged time step to be processed and returns the result
+  // of the last asynchronous execution.
+  int WaitForAnalysis()
+  {
+    if (this->ThreadId < 0)
+    {
+      return this->LastResult;
+    }
+    this->Lock.Lock();
+    while (this->StagedDescription)
+    {
+      this->Condition.Wait(this->Lock);
+    }
+    int result = this->LastResult;
+    this->Lock.Unlock();
+    return result;
+  }
+
+  // Processes the staged time step, if any, and joins the analysis thread.
+  void StopAnalysisThread()
+  {
+    if (this->ThreadId < 0)
+    {
+      return;
+    }
+    this->Lock.Lock();
+    this->Terminate = true;
+    this->Condition.Broadcast();
+    this->Lock.Unlock();
+    this->Threader->TerminateThread(this->ThreadId);
+    this->ThreadId = -1;
+    this->ReleaseAnalysisController();
+  }
 };
 
+namespace
+{
+// Pipelines can only execute in a separate thread when the simulation can
+// keep using MPI concurrently.
+bool vtkCPProcessorMPISupportsThreads()
+{
+#ifdef PARAVIEW_USE_MPI
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  if (initialized)
+  {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    return provided == MPI_THREAD_MULTIPLE;
+  }
+#endif
+  return true;
+}
+
+// Returns a copy of the data description whose grids and user data do not
+// share memory with the simulation, which may overwrite its arrays while the
+// pipelines execute. Only the grids that are needed are copied.
+vtkCPDataDescription* vtkCPProcessorNewStagedDescription(vtkCPDataDescription* source)
+{
+  vtkCPDataDescription* staged = vtkCPDataDescription::New();
+  staged->SetTimeData(source->GetTime(), source->GetTimeStep());
+  staged->SetForceOutput(source->GetForceOutput());
+  if (source->GetUserData())
+  {
+    vtkNew<vtkFieldData> userData;
+    userData->DeepCopy(source->GetUserData());
+    staged->SetUserData(userData.Get());
+  }
+  for (unsigned int i = 0; i < source->GetNumberOfInputDescriptions(); i++)
+  {
+    const char* name = source->GetInputDescriptionName(i);
+    vtkCPInputDataDescription* from = source->GetInputDescription(i);
+    staged->AddInput(name);
+    vtkCPInputDataDescription* to = staged->GetInputDescriptionByName(name);
+    to->SetGenerateMesh(from->GetGenerateMesh());
+    to->SetAllFields(from->GetAllFields());
+    to->SetWholeExtent(from->GetWholeExtent());
+    for (unsigned int j = 0; j < from->GetNumberOfFields(); j++)
+    {
+      const char* fieldName = from->GetFieldName(j);
+      if (from->IsFieldPointData(fieldName))
+      {
+        to->AddPointField(fieldName);
+      }
+      else
+      {
+        to->AddCellField(fieldName);
+      }
+    }
+    vtkDataObject* grid = from->GetGrid();
+    if (grid && (source->GetForceOutput() || from->GetIfGridIsNecessary()))
+    {
+      vtkDataObject* copy = grid->NewInstance();
+      copy->DeepCopy(grid);
+      to->SetGrid(copy);
+      copy->Delete();
+    }
+  }
+  return staged;
+}
+}
+
 vtkStandardNewMacro(vtkCPProcessor);
 vtkMultiProcessController* vtkCPProcessor::Controller = NULL;
 //----------------------------------------------------------------------------
@@ -49,6 +255,7 @@ vtkCPProcessor::vtkCPProcessor()
 {
   this->Internal = new vtkCPProcessorInternals;
   this->InitializationHelper = NULL;
+  this->Asynchronous = false;
 }
 
 //----------------------------------------------------------------------------
@@ -56,6 +263,7 @@ vtkCPProcessor::~vtkCPProcessor()
 {
   if (this->Internal)
   {
+    this->Internal->StopAnalysisThread();
     delete this->Internal;
     this->Internal = NULL;
   }
@@ -76,6 +284,7 @@ int vtkCPProcessor::AddPipeline(vtkCPPipeline* pipeline)
     return 0;
   }
 
+  this->Internal->WaitForAnalysis();
   this->Internal->Pipelines.push_back(pipeline);
   return 1;
 }
@@ -110,12 +319,14 @@ vtkCPPipeline* vtkCPProcessor::GetPipeline(int which)
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemovePipeline(vtkCPPipeline* pipeline)
 {
+  this->Internal->WaitForAnalysis();
   this->Internal->Pipelines.remove(pipeline);
 }
 
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemoveAllPipelines()
 {
+  this->Internal->WaitForAnalysis();
   this->Internal->Pipelines.clear();
 }
 
@@ -146,8 +357,12 @@ int vtkCPProcessor::Initialize(vtkMPICommunicatorOpaqueComm& comm)
   }
   if (this->InitializationHelper == NULL)
   {
+    // Catalyst communicates on a duplicate so that its messages never match
+    // the simulation's.
+    vtkNew<vtkMPICommunicator> simulationCommunicator;
+    simulationCommunicator->InitializeExternal(&comm);
     vtkMPICommunicator* communicator = vtkMPICommunicator::New();
-    communicator->InitializeExternal(&comm);
+    communicator->Duplicate(simulationCommunicator.Get());
     vtkMPIController* controller = vtkMPIController::New();
     controller->SetCommunicator(communicator);
     this->Controller = controller;
@@ -175,6 +390,9 @@ int vtkCPProcessor::RequestDataDescription(vtkCPDataDescription* dataDescription
     return 1;
   }
 
+  // the pipelines may still be executing on the previous time step.
+  this->Internal->WaitForAnalysis();
+
   // first set all inputs to be off and set to on as needed.
   // we don't use vtkCPInputDataDescription::Reset() because
   // that will reset any field names that were added in.
@@ -205,6 +423,55 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
     vtkWarningMacro("DataDescription is NULL.");
     return 0;
   }
+
+  // wait for the previous time step, this also bounds the memory used by the
+  // copies to a single time step.
+  int success = this->Internal->WaitForAnalysis();
+  if (!this->Asynchronous)
+  {
+    return this->ExecutePipelines(dataDescription);
+  }
+  const char* reason = NULL;
+  if (!vtkCPProcessorMPISupportsThreads())
+  {
+    reason = "MPI does not support MPI_THREAD_MULTIPLE.";
+  }
+  for (vtkCPProcessorInternals::PipelineListIterator iter = this->Internal->Pipelines.begin();
+       iter != this->Internal->Pipelines.end() && !reason; iter++)
+  {
+    if (!iter->GetPointer()->CanExecuteAsynchronously())
+    {
+      reason = "A pipeline cannot execute asynchronously.";
+    }
+  }
+  if (reason)
+  {
+    if (!this->Internal->WarnedSynchronous)
+    {
+      vtkWarningMacro(<< reason << " Co-processing is done synchronously.");
+      this->Internal->WarnedSynchronous = true;
+    }
+    // the analysis thread, if any, is idle; stop it so that the pipelines
+    // use the global controller again.
+    this->Internal->StopAnalysisThread();
+    return this->ExecutePipelines(dataDescription);
+  }
+
+  vtkCPDataDescription* staged = vtkCPProcessorNewStagedDescription(dataDescription);
+  dataDescription->ResetAll();
+
+  this->Internal->StartAnalysisThread(this);
+  this->Internal->Lock.Lock();
+  this->Internal->StagedDescription = staged;
+  this->Internal->Condition.Broadcast();
+  this->Internal->Lock.Unlock();
+  staged->Delete();
+  return success;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::ExecutePipelines(vtkCPDataDescription* dataDescription)
+{
   int success = 1;
   for (vtkCPProcessorInternals::PipelineListIterator iter = this->Internal->Pipelines.begin();
        iter != this->Internal->Pipelines.end(); iter++)
@@ -238,6 +505,8 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
 //----------------------------------------------------------------------------
 int vtkCPProcessor::Finalize()
 {
+  this->Internal->StopAnalysisThread();
+
   if (this->Controller)
   {
     this->Controller->SetGlobalController(NULL);
@@ -262,4 +531,5 @@ int vtkCPProcessor::Finalize()
 void vtkCPProcessor::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "Asynchronous: " << this->Asynchronous << "\n";
 }
@@ -104,6 +104,23 @@ public:
   /// implementation an opportunity to clean up, before it is destroyed.
   virtual int Finalize();
 
+  /// When on, CoProcess() copies the grids and the field data of
+  /// the data description and returns immediately. The pipelines then
+  /// execute on the copy in a separate analysis thread while the
+  /// simulation advances. Only one time step is staged at a time, so
+  /// the next call to RequestDataDescription() or CoProcess() waits
+  /// for the analysis of the previous time step to complete. In this
+  /// mode the return value of CoProcess() reports whether the pipelines
+  /// succeeded on the previously staged time step. The pipelines
+  /// communicate on a duplicate of the global controller's communicator
+  /// while the analysis thread runs. The mode requires MPI, if initialized,
+  /// to provide MPI_THREAD_MULTIPLE and all pipelines to support it (see
+  /// vtkCPPipeline::CanExecuteAsynchronously(), Python pipelines do not);
+  /// otherwise the pipelines execute synchronously. Off by default.
+  vtkSetMacro(Asynchronous, bool);
+  vtkGetMacro(Asynchronous, bool);
+  vtkBooleanMacro(Asynchronous, bool);
+
 protected:
   vtkCPProcessor();
   virtual ~vtkCPProcessor();
@@ -111,10 +128,18 @@ protected:
   /// Create a new instance of the InitializationHelper.
   virtual vtkObject* NewInitializationHelper();
 
+  /// Executes the pipelines that need to run for the given data
+  /// description and resets it afterwards. Return value is 1 for
+  /// success and 0 for failure.
+  int ExecutePipelines(vtkCPDataDescription* dataDescription);
+
+  bool Asynchronous;
+
 private:
   vtkCPProcessor(const vtkCPProcessor&) = delete;
   void operator=(const vtkCPProcessor&) = delete;
 
+  friend struct vtkCPProcessorInternals;
   vtkCPProcessorInternals* Internal;
   vtkObject* InitializationHelper;
   static vtkMultiProcessController* Controller;
@@ -53,6 +53,10 @@ public:
   /// is given. Returns 1 for success and 0 for failure.
   virtual int Finalize() VTK_OVERRIDE;
 
+  /// Python pipelines run in the interpreter of the simulation thread, which
+  /// holds the GIL, so they cannot execute in an analysis thread.
+  virtual bool CanExecuteAsynchronously() VTK_OVERRIDE { return false; }
+
 protected:
   vtkCPPythonScriptPipeline();
   virtual ~vtkCPPythonScriptPipeline();
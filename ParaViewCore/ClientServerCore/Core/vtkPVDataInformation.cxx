@@ -18,9 +18,11 @@
 #include "vtkAlgorithmOutput.h"
 #include "vtkBoundingBox.h"
 #include "vtkByteSwap.h"
+#include "vtkCallbackCommand.h"
 #include "vtkCellData.h"
 #include "vtkClientServerStream.h"
 #include "vtkCollection.h"
+#include "vtkCriticalSection.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataArray.h"
@@ -46,6 +48,7 @@
 #include "vtkPointData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkSelection.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkTable.h"
@@ -61,6 +64,57 @@ vtkStandardNewMacro(vtkPVDataInformation);
 
 std::map<std::string, std::string> helpers;
 
+namespace
+{
+// Information collected from leaf datasets is cached so that gathering
+// information for a composite dataset in which only a few blocks changed does
+// not have to walk all the unchanged blocks again. An item is valid as long as
+// the dataset's MTime (which includes the MTime of its points and attribute
+// arrays) has not changed. Items are removed when the dataset is deleted.
+// The cache is shared by all threads (e.g. the analysis thread of an
+// asynchronous Catalyst processor), so it is accessed under
+// vtkPVDataInformationCacheLock only.
+struct vtkPVDataInformationCacheItem
+{
+  vtkPVDataInformationCacheItem()
+    : MTime(0)
+    , NumberOfPoints(0)
+    , NumberOfCells(0)
+  {
+  }
+
+  vtkMTimeType MTime;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  vtkSmartPointer<vtkPVDataInformation> Information;
+};
+
+typedef std::map<vtkObject*, vtkPVDataInformationCacheItem> vtkPVDataInformationCacheType;
+vtkPVDataInformationCacheType vtkPVDataInformationCache;
+vtkSimpleCriticalSection vtkPVDataInformationCacheLock;
+
+void vtkPVDataInformationCacheRemove(vtkObject* caller, unsigned long, void*, void*)
+{
+  vtkPVDataInformationCacheLock.Lock();
+  vtkPVDataInformationCache.erase(caller);
+  vtkPVDataInformationCacheLock.Unlock();
+}
+
+vtkPVDataInformationCacheItem& vtkPVDataInformationCacheGetItem(vtkDataSet* data)
+{
+  vtkPVDataInformationCacheType::iterator iter = vtkPVDataInformationCache.find(data);
+  if (iter == vtkPVDataInformationCache.end())
+  {
+    vtkNew<vtkCallbackCommand> observer;
+    observer->SetCallback(&vtkPVDataInformationCacheRemove);
+    data->AddObserver(vtkCommand::DeleteEvent, observer.Get());
+    iter = vtkPVDataInformationCache.insert(
+      vtkPVDataInformationCacheType::value_type(data, vtkPVDataInformationCacheItem())).first;
+  }
+  return iter->second;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkPVDataInformation::vtkPVDataInformation()
 {
@@ -463,6 +517,44 @@ void vtkPVDataInformation::CopyCommonMetaData(vtkDataObject* data, vtkInformatio
 
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyFromDataSet(vtkDataSet* data)
+{
+  const vtkMTimeType mtime = data->GetMTime();
+  const vtkIdType numPoints = data->GetNumberOfPoints();
+  const vtkIdType numCells =
+    data->GetDataObjectType() != VTK_HYPER_OCTREE ? data->GetNumberOfCells() : 0;
+
+  vtkSmartPointer<vtkPVDataInformation> information;
+  vtkPVDataInformationCacheLock.Lock();
+  vtkPVDataInformationCacheItem& item = vtkPVDataInformationCacheGetItem(data);
+  if (item.Information && item.MTime == mtime && item.NumberOfPoints == numPoints &&
+    item.NumberOfCells == numCells)
+  {
+    information = item.Information;
+  }
+  vtkPVDataInformationCacheLock.Unlock();
+
+  if (!information)
+  {
+    // the dataset is walked without holding the lock.
+    information = vtkSmartPointer<vtkPVDataInformation>::New();
+    information->CopyFromDataSetUncached(data);
+
+    vtkPVDataInformationCacheLock.Lock();
+    vtkPVDataInformationCacheItem& newItem = vtkPVDataInformationCacheGetItem(data);
+    newItem.MTime = mtime;
+    newItem.NumberOfPoints = numPoints;
+    newItem.NumberOfCells = numCells;
+    newItem.Information = information;
+    vtkPVDataInformationCacheLock.Unlock();
+  }
+
+  // DeepCopy() accumulates the point array information, so start afresh.
+  this->PointArrayInformation->Initialize();
+  this->DeepCopy(information, /*copyCompositeInformation=*/false);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataInformation::CopyFromDataSetUncached(vtkDataSet* data)
 {
   int idx;
   double* bds;
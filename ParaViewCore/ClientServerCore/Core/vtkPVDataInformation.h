@@ -288,7 +288,16 @@ protected:
   void CopyFromCompositeDataSet(vtkCompositeDataSet* data);
   void CopyFromCompositeDataSetInitialize(vtkCompositeDataSet* data);
   void CopyFromCompositeDataSetFinalize(vtkCompositeDataSet* data);
+  //@{
+  /**
+   * Collects information from a leaf dataset. CopyFromDataSet() reuses the
+   * information collected earlier for the same dataset if the dataset has not
+   * been modified since, while CopyFromDataSetUncached() always walks the
+   * dataset.
+   */
   virtual void CopyFromDataSet(vtkDataSet* data);
+  void CopyFromDataSetUncached(vtkDataSet* data);
+  //@}
   void CopyFromGenericDataSet(vtkGenericDataSet* data);
   void CopyFromGraph(vtkGraph* graph);
   void CopyFromTable(vtkTable* table);
@@ -12,6 +12,7 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+#include "vtkPython.h" // must be the first thing that's included
 #include "vtkPythonCalculator.h"
 
 #include "vtkCellData.h"
@@ -26,6 +27,8 @@
 #include "vtkPointData.h"
 #include "vtkProcessModule.h"
 #include "vtkPythonInterpreter.h"
+#include "vtkPythonUtil.h"
+#include "vtkSmartPyObject.h"
 
 #include <algorithm>
 #include <map>
@@ -43,6 +46,8 @@ vtkPythonCalculator::vtkPythonCalculator()
   this->SetArrayName("result");
   this->SetExecuteMethod(vtkPythonCalculator::ExecuteScript, this);
   this->ArrayAssociation = vtkDataObject::FIELD_ASSOCIATION_POINTS;
+  this->PersistentState = false;
+  this->HasPersistentState = false;
 }
 
 //----------------------------------------------------------------------------
@@ -50,6 +55,27 @@ vtkPythonCalculator::~vtkPythonCalculator()
 {
   this->SetExpression(NULL);
   this->SetArrayName(NULL);
+
+  if (this->HasPersistentState && vtkPythonInterpreter::IsInitialized())
+  {
+    std::ostringstream python_stream;
+    python_stream << "from paraview import calculator\n"
+                  << "calculator.release_state('" << this->GetAddressAsString() << "')\n";
+    vtkPythonInterpreter::RunSimpleString(python_stream.str().c_str());
+  }
+}
+
+//----------------------------------------------------------------------------
+std::string vtkPythonCalculator::GetAddressAsString()
+{
+  char addrofthis[1024];
+  sprintf(addrofthis, "%p", this);
+  char* aplus = addrofthis;
+  if ((addrofthis[0] == '0') && ((addrofthis[1] == 'x') || addrofthis[1] == 'X'))
+  {
+    aplus += 2; // skip over "0x"
+  }
+  return std::string(aplus);
 }
 
 //----------------------------------------------------------------------------
@@ -121,25 +147,69 @@ void vtkPythonCalculator::Exec(const char* expression)
   std::replace(orgscript.begin(), orgscript.end(), '\'', '"');
 
   // Set self to point to this
-  char addrofthis[1024];
-  sprintf(addrofthis, "%p", this);
-  char* aplus = addrofthis;
-  if ((addrofthis[0] == '0') && ((addrofthis[1] == 'x') || addrofthis[1] == 'X'))
+  std::string aplus = this->GetAddressAsString();
+
+  if (this->PersistentState)
   {
-    aplus += 2; // skip over "0x"
+    this->ExecPersistent(orgscript, aplus);
+    return;
   }
 
   std::ostringstream python_stream;
   python_stream << "import paraview\n"
                 << "from paraview import calculator\n"
-                << "from paraview.vtk.vtkPVClientServerCoreDefault import vtkPythonCalculator\n"
-                << "calculator.execute(vtkPythonCalculator('" << aplus << "'), '"
+                << "from paraview.vtk.vtkPVClientServerCoreDefault import vtkPythonCalculator\n";
+  if (this->HasPersistentState)
+  {
+    python_stream << "calculator.release_state('" << aplus << "')\n";
+    this->HasPersistentState = false;
+  }
+  python_stream << "calculator.execute(vtkPythonCalculator('" << aplus << "'), '"
                 << orgscript.c_str() << "')\n";
 
   vtkPythonInterpreter::Initialize();
   vtkPythonInterpreter::RunSimpleString(python_stream.str().c_str());
 }
 
+//----------------------------------------------------------------------------
+void vtkPythonCalculator::ExecPersistent(const std::string& expression, const std::string& key)
+{
+  // The state is keyed on the address of this and released in the
+  // destructor. calculator.execute_persistent() is called directly rather
+  // than through a script, which would have to be parsed on every execution.
+  vtkPythonInterpreter::Initialize();
+  vtkPythonScopeGilEnsurer gilEnsurer;
+
+  // The wrapping module must be imported for this to be wrapped as a
+  // vtkPythonCalculator.
+  vtkSmartPyObject wrappingModule(
+    PyImport_ImportModule("paraview.vtk.vtkPVClientServerCoreDefault"));
+  vtkSmartPyObject calculatorModule(PyImport_ImportModule("paraview.calculator"));
+  if (!wrappingModule || !calculatorModule)
+  {
+    vtkErrorMacro("Failed to import `paraview.calculator`.");
+    if (PyErr_Occurred())
+    {
+      PyErr_Print();
+      PyErr_Clear();
+    }
+    return;
+  }
+
+  this->HasPersistentState = true;
+  vtkSmartPyObject methodName(PyString_FromString("execute_persistent"));
+  vtkSmartPyObject self(vtkPythonUtil::GetObjectFromPointer(this));
+  vtkSmartPyObject expressionObj(PyString_FromString(expression.c_str()));
+  vtkSmartPyObject keyObj(PyString_FromString(key.c_str()));
+  vtkSmartPyObject retVal(PyObject_CallMethodObjArgs(calculatorModule, methodName.GetPointer(),
+    self.GetPointer(), expressionObj.GetPointer(), keyObj.GetPointer(), NULL));
+  if (!retVal && PyErr_Occurred())
+  {
+    PyErr_Print();
+    PyErr_Clear();
+  }
+}
+
 //----------------------------------------------------------------------------
 int vtkPythonCalculator::FillOutputPortInformation(int vtkNotUsed(port), vtkInformation* info)
 {
@@ -169,4 +239,5 @@ int vtkPythonCalculator::FillInputPortInformation(int port, vtkInformation* info
 void vtkPythonCalculator::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "PersistentState: " << this->PersistentState << endl;
 }
@@ -28,6 +28,10 @@
  * valid Python variable, it has to be accessed through a dictionary called
  * arrays (i.e. arrays['array_name']). The points can be accessed using the
  * points variable.
+ *
+ * When PersistentState is on, the compiled expression and the wrapped inputs
+ * are kept between executions, which reduces the overhead of re-executing
+ * the filter, e.g. when changing time.
 */
 
 #ifndef vtkPythonCalculator_h
@@ -36,6 +40,8 @@
 #include "vtkPVClientServerCoreDefaultModule.h" //needed for exports
 #include "vtkProgrammableFilter.h"
 
+#include <string> // for std::string
+
 class VTKPVCLIENTSERVERCOREDEFAULT_EXPORT vtkPythonCalculator : public vtkProgrammableFilter
 {
 public:
@@ -53,6 +59,20 @@ public:
   vtkGetMacro(ArrayAssociation, int);
   //@}
 
+  //@{
+  /**
+   * When on, keep the Python state of the filter between executions: the
+   * expression is compiled only when it changes, the inputs and their arrays
+   * are wrapped again only when an input (or one of its blocks) is modified,
+   * and results that are an existing VTK array are added to the output
+   * without a copy. The wrapped inputs are held until the next execution or
+   * until the filter is deleted. Default is off.
+   */
+  vtkSetMacro(PersistentState, bool);
+  vtkGetMacro(PersistentState, bool);
+  vtkBooleanMacro(PersistentState, bool);
+  //@}
+
   //@{
   /**
    * Set the text of the python expression to execute. This expression
@@ -83,6 +103,12 @@ protected:
    */
   void Exec(const char*);
 
+  /**
+   * Evaluates the expression with the Python state kept for this filter, see
+   * PersistentState.
+   */
+  void ExecPersistent(const std::string& expression, const std::string& key);
+
   int FillOutputPortInformation(int port, vtkInformation* info) VTK_OVERRIDE;
 
   // overridden to allow multiple inputs to port 0
@@ -96,10 +122,21 @@ protected:
   char* Expression;
   char* ArrayName;
   int ArrayAssociation;
+  bool PersistentState;
 
 private:
   vtkPythonCalculator(const vtkPythonCalculator&) = delete;
   void operator=(const vtkPythonCalculator&) = delete;
+
+  /**
+   * Returns the address of this, as understood by the Python constructor of
+   * wrapped VTK objects.
+   */
+  std::string GetAddressAsString();
+
+  // Set once a persistent state has been created on the Python side, so that
+  // it is released with the filter.
+  bool HasPersistentState;
 };
 
 #endif
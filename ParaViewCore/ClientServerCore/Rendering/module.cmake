@@ -24,6 +24,7 @@ vtk_module(vtkPVClientServerCoreRendering
     vtkViewsCore
     ${__dependencies}
   PRIVATE_DEPENDS
+    vtklz4
     vtksys
     vtkzlib
   TEST_LABELS
@@ -49,6 +49,8 @@ vtkCacheSizeKeeper::vtkCacheSizeKeeper()
 {
   this->CacheSize = 0;
   this->CacheFull = 0;
+  this->EvictionCount = 1;
+  this->RequestedEvictionCount = 0;
   this->CacheLimit = 100 * 1024; // 100 MBs.
 }
 
@@ -64,4 +66,5 @@ void vtkCacheSizeKeeper::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "CacheSize: " << this->CacheSize << endl;
   os << indent << "CacheFull: " << this->CacheFull << endl;
   os << indent << "CacheLimit: " << this->CacheLimit << endl;
+  os << indent << "EvictionCount: " << this->EvictionCount << endl;
 }
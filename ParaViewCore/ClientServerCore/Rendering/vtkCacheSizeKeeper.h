@@ -63,6 +63,17 @@ public:
     this->CacheSize = (this->CacheSize > kbytes) ? (this->CacheSize - kbytes) : 0;
   }
 
+  /**
+   * Report that cached data of size \c freed_kbytes was replaced by data of
+   * size \c kbytes. Unlike AddCacheSize(), this is allowed when the cache is
+   * full, since it is used by caches that evict data to make room.
+   */
+  void ReplaceCacheSize(unsigned long freed_kbytes, unsigned long kbytes)
+  {
+    this->FreeCacheSize(freed_kbytes);
+    this->CacheSize += kbytes;
+  }
+
   //@{
   /**
    * Get the size of cache reported to this keeper.
@@ -88,6 +99,34 @@ public:
   vtkSetMacro(CacheFull, int);
   //@}
 
+  //@{
+  /**
+   * Get/Set the number of least recently used time steps a cache evicts to
+   * make room for a new one when the cache is full. Like the cache fullness,
+   * vtkPVView::Update synchronizes it among all participating processes so
+   * that they all evict the same time steps. Default is 1.
+   */
+  vtkGetMacro(EvictionCount, int);
+  vtkSetMacro(EvictionCount, int);
+  //@}
+
+  //@{
+  /**
+   * Report that a cache had to evict \c count time steps to fit the data it
+   * saved. vtkPVView::Update sets EvictionCount to the largest count reported
+   * on any process since the last update.
+   */
+  void RequestEvictionCount(int count)
+  {
+    if (count > this->RequestedEvictionCount)
+    {
+      this->RequestedEvictionCount = count;
+    }
+  }
+  vtkGetMacro(RequestedEvictionCount, int);
+  void ResetRequestedEvictionCount() { this->RequestedEvictionCount = 0; }
+  //@}
+
 protected:
   static vtkCacheSizeKeeper* New();
   vtkCacheSizeKeeper();
@@ -96,6 +135,8 @@ protected:
   unsigned long CacheSize;
   unsigned long CacheLimit;
   int CacheFull;
+  int EvictionCount;
+  int RequestedEvictionCount;
 
 private:
   vtkCacheSizeKeeper(const vtkCacheSizeKeeper&) = delete;
@@ -235,6 +235,9 @@ int vtkChartRepresentation::RequestData(
       vtkNew<vtkPVMergeTablesMultiBlock> algo;
       reductionFilter->SetPostGatherHelper(algo.GetPointer());
       reductionFilter->SetController(pm->GetGlobalController());
+      // merging tables is associative, so reduce along a tree to avoid
+      // funneling every rank's tables through the root.
+      reductionFilter->SetTreeFanIn(4);
       reductionFilter->SetInputData(data);
       reductionFilter->Update();
 
@@ -14,16 +14,20 @@
 =========================================================================*/
 #include "vtkMPIMoveData.h"
 
+#include "vtkByteSwap.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
 #include "vtkDataSetReader.h"
 #include "vtkDirectedGraph.h"
 #include "vtkGenericDataObjectReader.h"
 #include "vtkGenericDataObjectWriter.h"
 #include "vtkGraphReader.h"
 #include "vtkGraphWriter.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -32,13 +36,18 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiProcessControllerHelper.h"
+#include "vtkNew.h"
 #include "vtkNonOverlappingAMR.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineFilter.h"
 #include "vtkOverlappingAMR.h"
 #include "vtkPVConfig.h"
+#include "vtkPVDataCompressor.h"
+#include "vtkPVLZ4DataCompressor.h"
 #include "vtkPVSession.h"
+#include "vtkPVZLibDataCompressor.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
 #include "vtkSmartPointer.h"
@@ -49,10 +58,12 @@
 #include "vtkTimerLog.h"
 #include "vtkToolkits.h"
 #include "vtkUndirectedGraph.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include "vtk_zlib.h"
 #include <sstream>
+#include <string>
 #include <vector>
 
 #ifdef PARAVIEW_USE_MPI
@@ -62,10 +73,19 @@
 
 #include <vector>
 
-bool vtkMPIMoveData::UseZLibCompression = false;
+int vtkMPIMoveData::CompressionMethod = vtkMPIMoveData::COMPRESSION_NONE;
+double vtkMPIMoveData::AutomaticCompressionBandwidthThreshold = 100.0;
+double vtkMPIMoveData::MeasuredBandwidth[vtkMPIMoveData::NUMBER_OF_CONNECTIONS] = { 0.0, 0.0,
+  0.0 };
 
 namespace
 {
+std::string vtkMPIMoveDataCustomCompressorTag;
+
+// Transfers smaller than this are dominated by latency and are not used to
+// estimate the connection bandwidth.
+const vtkIdType vtkMPIMoveDataMinimumSampleSize = 1 << 20;
+
 bool vtkMPIMoveDataMerge(
   std::vector<vtkSmartPointer<vtkDataObject> >& pieces, vtkDataObject* result)
 {
@@ -96,6 +116,558 @@ void unsetGlobalIdsAttribute(vtkDataObject* piece)
     it->Delete();
   }
 }
+
+//-----------------------------------------------------------------------------
+// Native binary marshaling for vtkPolyData and vtkUnstructuredGrid.
+//
+// Instead of round-tripping through the legacy writer/reader, the dataset is
+// described as a small header followed by a list of contiguous blocks that
+// reference the raw memory of the points, cell arrays and attribute arrays.
+// The blocks are gathered into the send buffer with a single memcpy each and
+// the receiver copies them straight into newly allocated arrays. Datasets
+// that cannot be represented this way (non-contiguous or non-numeric arrays,
+// polyhedral faces, other data types) fall back to the legacy path.
+const char vtkMPIMoveDataBinaryMagic[] = "pvbn";
+const vtkTypeInt64 vtkMPIMoveDataBinaryVersion = 1;
+
+class vtkMPIMoveDataBinaryWriter
+{
+public:
+  vtkMPIMoveDataBinaryWriter()
+    : HeaderBlockStart(0)
+  {
+  }
+
+  void WriteInt(vtkTypeInt64 value)
+  {
+    this->AppendHeader(&value, sizeof(value));
+  }
+
+  void WriteString(const char* str)
+  {
+    if (str == NULL)
+    {
+      this->WriteInt(-1);
+      return;
+    }
+    vtkTypeInt64 length = static_cast<vtkTypeInt64>(strlen(str));
+    this->WriteInt(length);
+    this->AppendHeader(str, static_cast<size_t>(length));
+  }
+
+  // Records a reference to external memory. The memory must remain valid
+  // until Finalize() is called.
+  void WriteBlock(const void* data, size_t length)
+  {
+    this->CloseHeaderBlock();
+    if (length > 0)
+    {
+      BlockInfo info;
+      info.Data = static_cast<const char*>(data);
+      info.Offset = 0;
+      info.Length = length;
+      this->Blocks.push_back(info);
+    }
+  }
+
+  bool WriteArray(vtkAbstractArray* aa)
+  {
+    vtkDataArray* array = vtkDataArray::SafeDownCast(aa);
+    // bit arrays report the standard memory layout but have no per-value
+    // size, so they go through the legacy writer as well.
+    if (array == NULL || !array->HasStandardMemoryLayout() ||
+      array->GetDataType() == VTK_BIT || array->GetDataTypeSize() == 0)
+    {
+      return false;
+    }
+    const vtkIdType numValues = array->GetNumberOfTuples() * array->GetNumberOfComponents();
+    this->WriteInt(array->GetDataType());
+    this->WriteInt(array->GetNumberOfComponents());
+    this->WriteInt(array->GetNumberOfTuples());
+    this->WriteString(array->GetName());
+    this->WriteInt(array->HasAComponentName() ? array->GetNumberOfComponents() : 0);
+    if (array->HasAComponentName())
+    {
+      for (int cc = 0; cc < array->GetNumberOfComponents(); ++cc)
+      {
+        this->WriteString(array->GetComponentName(cc));
+      }
+    }
+    if (numValues > 0)
+    {
+      this->WriteBlock(array->GetVoidPointer(0),
+        static_cast<size_t>(numValues) * static_cast<size_t>(array->GetDataTypeSize()));
+    }
+    return true;
+  }
+
+  bool WriteFieldData(vtkFieldData* fd)
+  {
+    this->WriteInt(fd->GetNumberOfArrays());
+    for (int cc = 0; cc < fd->GetNumberOfArrays(); ++cc)
+    {
+      if (!this->WriteArray(fd->GetAbstractArray(cc)))
+      {
+        return false;
+      }
+    }
+    if (vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd))
+    {
+      int indices[vtkDataSetAttributes::NUM_ATTRIBUTES];
+      dsa->GetAttributeIndices(indices);
+      for (int cc = 0; cc < vtkDataSetAttributes::NUM_ATTRIBUTES; ++cc)
+      {
+        this->WriteInt(indices[cc]);
+      }
+    }
+    return true;
+  }
+
+  bool WriteCellArray(vtkCellArray* cells)
+  {
+    this->WriteInt(cells ? 1 : 0);
+    if (cells)
+    {
+      this->WriteInt(cells->GetNumberOfCells());
+      return this->WriteArray(cells->GetData());
+    }
+    return true;
+  }
+
+  // Gathers the header and all referenced blocks into a single buffer
+  // allocated with new[].
+  char* Finalize(vtkIdType& length)
+  {
+    this->CloseHeaderBlock();
+    size_t total = 0;
+    for (size_t cc = 0; cc < this->Blocks.size(); ++cc)
+    {
+      total += this->Blocks[cc].Length;
+    }
+    char* buffer = new char[total];
+    char* ptr = buffer;
+    for (size_t cc = 0; cc < this->Blocks.size(); ++cc)
+    {
+      const BlockInfo& info = this->Blocks[cc];
+      const char* src = info.Data ? info.Data : &this->Header[info.Offset];
+      memcpy(ptr, src, info.Length);
+      ptr += info.Length;
+    }
+    length = static_cast<vtkIdType>(total);
+    return buffer;
+  }
+
+private:
+  struct BlockInfo
+  {
+    const char* Data; // NULL for blocks that live in this->Header.
+    size_t Offset;
+    size_t Length;
+  };
+
+  void AppendHeader(const void* data, size_t length)
+  {
+    const char* src = static_cast<const char*>(data);
+    this->Header.insert(this->Header.end(), src, src + length);
+  }
+
+  // Flushes header bytes appended since the last block as a block of their own.
+  void CloseHeaderBlock()
+  {
+    if (this->Header.size() > this->HeaderBlockStart)
+    {
+      BlockInfo info;
+      info.Data = NULL;
+      info.Offset = this->HeaderBlockStart;
+      info.Length = this->Header.size() - this->HeaderBlockStart;
+      this->Blocks.push_back(info);
+    }
+    this->HeaderBlockStart = this->Header.size();
+  }
+
+  std::vector<char> Header;
+  std::vector<BlockInfo> Blocks;
+  size_t HeaderBlockStart;
+};
+
+class vtkMPIMoveDataBinaryReader
+{
+public:
+  vtkMPIMoveDataBinaryReader(const char* buffer, vtkIdType length)
+    : Buffer(buffer)
+    , Length(static_cast<size_t>(length))
+    , Position(0)
+    , Swap(false)
+    , Failed(false)
+    , IdTypeSize(sizeof(vtkIdType))
+  {
+  }
+
+  void SetSwap(bool swap) { this->Swap = swap; }
+
+  // Size of vtkIdType on the sending process. vtkIdType arrays are widened or
+  // narrowed to the local size when the two differ.
+  void SetIdTypeSize(size_t size) { this->IdTypeSize = size; }
+  bool GetFailed() const { return this->Failed; }
+
+  const char* ReadBytes(size_t length)
+  {
+    if (this->Failed || this->Position + length > this->Length)
+    {
+      this->Failed = true;
+      return NULL;
+    }
+    const char* ptr = this->Buffer + this->Position;
+    this->Position += length;
+    return ptr;
+  }
+
+  vtkTypeInt64 ReadInt()
+  {
+    vtkTypeInt64 value = 0;
+    if (const char* ptr = this->ReadBytes(sizeof(value)))
+    {
+      memcpy(&value, ptr, sizeof(value));
+      if (this->Swap)
+      {
+        vtkByteSwap::SwapVoidRange(&value, 1, sizeof(value));
+      }
+    }
+    return value;
+  }
+
+  std::string ReadString(bool& valid)
+  {
+    vtkTypeInt64 length = this->ReadInt();
+    valid = (length >= 0);
+    if (length <= 0)
+    {
+      return std::string();
+    }
+    const char* ptr = this->ReadBytes(static_cast<size_t>(length));
+    return ptr ? std::string(ptr, static_cast<size_t>(length)) : std::string();
+  }
+
+  vtkSmartPointer<vtkDataArray> ReadArray()
+  {
+    const int dataType = static_cast<int>(this->ReadInt());
+    const int numComps = static_cast<int>(this->ReadInt());
+    const vtkIdType numTuples = static_cast<vtkIdType>(this->ReadInt());
+    bool hasName;
+    const std::string name = this->ReadString(hasName);
+    const int numCompNames = static_cast<int>(this->ReadInt());
+    if (this->Failed || numComps < 1 || numTuples < 0)
+    {
+      this->Failed = true;
+      return NULL;
+    }
+
+    vtkSmartPointer<vtkDataArray> array;
+    array.TakeReference(vtkDataArray::CreateDataArray(dataType));
+    if (array == NULL || dataType == VTK_BIT || array->GetDataTypeSize() == 0)
+    {
+      this->Failed = true;
+      return NULL;
+    }
+    array->SetNumberOfComponents(numComps);
+    if (hasName)
+    {
+      array->SetName(name.c_str());
+    }
+    for (int cc = 0; cc < numCompNames; ++cc)
+    {
+      bool valid;
+      const std::string compName = this->ReadString(valid);
+      if (valid)
+      {
+        array->SetComponentName(cc, compName.c_str());
+      }
+    }
+    array->SetNumberOfTuples(numTuples);
+
+    const size_t wordSize = static_cast<size_t>(array->GetDataTypeSize());
+    const size_t numValues = static_cast<size_t>(numTuples) * static_cast<size_t>(numComps);
+    if (numValues > 0 && dataType == VTK_ID_TYPE && this->IdTypeSize != wordSize)
+    {
+      if (!this->ReadIds(static_cast<vtkIdTypeArray*>(array.GetPointer()), numValues))
+      {
+        return NULL;
+      }
+    }
+    else if (numValues > 0)
+    {
+      const char* src = this->ReadBytes(numValues * wordSize);
+      if (src == NULL)
+      {
+        return NULL;
+      }
+      void* dest = array->GetVoidPointer(0);
+      memcpy(dest, src, numValues * wordSize);
+      if (this->Swap && wordSize > 1)
+      {
+        vtkByteSwap::SwapVoidRange(dest, numValues, wordSize);
+      }
+    }
+    return array;
+  }
+
+  bool ReadFieldData(vtkFieldData* fd)
+  {
+    const int numArrays = static_cast<int>(this->ReadInt());
+    for (int cc = 0; cc < numArrays && !this->Failed; ++cc)
+    {
+      vtkSmartPointer<vtkDataArray> array = this->ReadArray();
+      if (array)
+      {
+        fd->AddArray(array);
+      }
+    }
+    if (vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd))
+    {
+      for (int cc = 0; cc < vtkDataSetAttributes::NUM_ATTRIBUTES; ++cc)
+      {
+        const int index = static_cast<int>(this->ReadInt());
+        if (index >= 0 && index < numArrays)
+        {
+          dsa->SetActiveAttribute(index, cc);
+        }
+      }
+    }
+    return !this->Failed;
+  }
+
+  vtkSmartPointer<vtkCellArray> ReadCellArray()
+  {
+    if (this->ReadInt() == 0)
+    {
+      return NULL;
+    }
+    const vtkIdType numCells = static_cast<vtkIdType>(this->ReadInt());
+    vtkSmartPointer<vtkDataArray> data = this->ReadArray();
+    vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(data);
+    if (ids == NULL)
+    {
+      this->Failed = true;
+      return NULL;
+    }
+    vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+    cells->SetCells(numCells, ids);
+    return cells;
+  }
+
+private:
+  // Reads ids written with a vtkIdType of a different size. Fails if an id
+  // does not fit in the local vtkIdType.
+  bool ReadIds(vtkIdTypeArray* array, size_t numValues)
+  {
+    const char* src = this->ReadBytes(numValues * this->IdTypeSize);
+    if (src == NULL)
+    {
+      return false;
+    }
+    vtkIdType* dest = array->GetPointer(0);
+    for (size_t cc = 0; cc < numValues; ++cc, src += this->IdTypeSize)
+    {
+      vtkTypeInt64 value;
+      if (this->IdTypeSize == 4)
+      {
+        vtkTypeInt32 value32;
+        memcpy(&value32, src, sizeof(value32));
+        if (this->Swap)
+        {
+          vtkByteSwap::SwapVoidRange(&value32, 1, sizeof(value32));
+        }
+        value = value32;
+      }
+      else
+      {
+        memcpy(&value, src, sizeof(value));
+        if (this->Swap)
+        {
+          vtkByteSwap::SwapVoidRange(&value, 1, sizeof(value));
+        }
+      }
+      if (value < static_cast<vtkTypeInt64>(VTK_ID_MIN) ||
+        value > static_cast<vtkTypeInt64>(VTK_ID_MAX))
+      {
+        vtkGenericWarningMacro("Id " << value << " does not fit in vtkIdType.");
+        this->Failed = true;
+        return false;
+      }
+      dest[cc] = static_cast<vtkIdType>(value);
+    }
+    return true;
+  }
+
+  const char* Buffer;
+  size_t Length;
+  size_t Position;
+  bool Swap;
+  bool Failed;
+  size_t IdTypeSize;
+};
+
+// Returns true and a new[] allocated buffer if `data` could be marshaled with
+// the native binary encoding.
+bool vtkMPIMoveDataBinaryMarshal(vtkDataObject* data, char*& buffer, vtkIdType& length)
+{
+  vtkPolyData* pd = vtkPolyData::SafeDownCast(data);
+  vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data);
+  if (!(pd && strcmp(pd->GetClassName(), "vtkPolyData") == 0) &&
+    !(ug && strcmp(ug->GetClassName(), "vtkUnstructuredGrid") == 0))
+  {
+    // subclasses may carry state the binary encoding does not know about.
+    return false;
+  }
+  if (ug && ug->GetFaces() != NULL)
+  {
+    return false;
+  }
+
+  vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+  vtkPoints* points = pd ? pd->GetPoints() : ug->GetPoints();
+
+  vtkMPIMoveDataBinaryWriter writer;
+  char magic[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  memcpy(magic, vtkMPIMoveDataBinaryMagic, 4);
+#ifdef VTK_WORDS_BIGENDIAN
+  magic[4] = 1;
+#endif
+  magic[5] = static_cast<char>(sizeof(vtkIdType));
+  writer.WriteBlock(magic, sizeof(magic));
+  writer.WriteInt(vtkMPIMoveDataBinaryVersion);
+  writer.WriteInt(data->GetDataObjectType());
+
+  bool status = true;
+  writer.WriteInt(points ? 1 : 0);
+  if (points)
+  {
+    status = writer.WriteArray(points->GetData());
+  }
+  if (pd)
+  {
+    status = status && writer.WriteCellArray(pd->GetVerts()) &&
+      writer.WriteCellArray(pd->GetLines()) && writer.WriteCellArray(pd->GetPolys()) &&
+      writer.WriteCellArray(pd->GetStrips());
+  }
+  else
+  {
+    const bool hasCells = ug->GetCells() != NULL && ug->GetCellTypesArray() != NULL &&
+      ug->GetCellLocationsArray() != NULL;
+    writer.WriteInt(hasCells ? 1 : 0);
+    if (hasCells)
+    {
+      status = status && writer.WriteArray(ug->GetCellTypesArray()) &&
+        writer.WriteArray(ug->GetCellLocationsArray()) && writer.WriteCellArray(ug->GetCells());
+    }
+  }
+  status = status && writer.WriteFieldData(ds->GetPointData()) &&
+    writer.WriteFieldData(ds->GetCellData()) && writer.WriteFieldData(ds->GetFieldData());
+  if (!status)
+  {
+    return false;
+  }
+
+  buffer = writer.Finalize(length);
+  return true;
+}
+
+bool vtkMPIMoveDataIsBinaryMarshaled(const char* buffer, vtkIdType length)
+{
+  return length >= 8 && strncmp(buffer, vtkMPIMoveDataBinaryMagic, 4) == 0;
+}
+
+// Reconstructs a dataset from a buffer produced by vtkMPIMoveDataBinaryMarshal.
+vtkSmartPointer<vtkDataObject> vtkMPIMoveDataBinaryUnmarshal(const char* buffer, vtkIdType length)
+{
+  vtkMPIMoveDataBinaryReader reader(buffer, length);
+  const char* magic = reader.ReadBytes(8);
+  if (magic == NULL)
+  {
+    return NULL;
+  }
+#ifdef VTK_WORDS_BIGENDIAN
+  reader.SetSwap(magic[4] == 0);
+#else
+  reader.SetSwap(magic[4] != 0);
+#endif
+  if (magic[5] != 4 && magic[5] != 8)
+  {
+    vtkGenericWarningMacro("Unsupported vtkIdType size " << static_cast<int>(magic[5]));
+    return NULL;
+  }
+  reader.SetIdTypeSize(static_cast<size_t>(magic[5]));
+  if (reader.ReadInt() != vtkMPIMoveDataBinaryVersion)
+  {
+    vtkGenericWarningMacro("Unsupported binary marshaling version.");
+    return NULL;
+  }
+
+  const int dataType = static_cast<int>(reader.ReadInt());
+  vtkSmartPointer<vtkDataSet> ds;
+  vtkPolyData* pd = NULL;
+  vtkUnstructuredGrid* ug = NULL;
+  if (dataType == VTK_POLY_DATA)
+  {
+    pd = vtkPolyData::New();
+    ds.TakeReference(pd);
+  }
+  else if (dataType == VTK_UNSTRUCTURED_GRID)
+  {
+    ug = vtkUnstructuredGrid::New();
+    ds.TakeReference(ug);
+  }
+  else
+  {
+    vtkGenericWarningMacro("Unsupported data type " << dataType);
+    return NULL;
+  }
+
+  if (reader.ReadInt() != 0)
+  {
+    vtkSmartPointer<vtkDataArray> pointsData = reader.ReadArray();
+    if (pointsData)
+    {
+      vtkNew<vtkPoints> points;
+      points->SetData(pointsData);
+      vtkPointSet::SafeDownCast(ds)->SetPoints(points.GetPointer());
+    }
+  }
+
+  if (pd)
+  {
+    vtkSmartPointer<vtkCellArray> verts = reader.ReadCellArray();
+    vtkSmartPointer<vtkCellArray> lines = reader.ReadCellArray();
+    vtkSmartPointer<vtkCellArray> polys = reader.ReadCellArray();
+    vtkSmartPointer<vtkCellArray> strips = reader.ReadCellArray();
+    pd->SetVerts(verts);
+    pd->SetLines(lines);
+    pd->SetPolys(polys);
+    pd->SetStrips(strips);
+  }
+  else if (reader.ReadInt() != 0)
+  {
+    vtkSmartPointer<vtkDataArray> types = reader.ReadArray();
+    vtkSmartPointer<vtkDataArray> locations = reader.ReadArray();
+    vtkSmartPointer<vtkCellArray> cells = reader.ReadCellArray();
+    vtkUnsignedCharArray* typesArray = vtkUnsignedCharArray::SafeDownCast(types);
+    vtkIdTypeArray* locationsArray = vtkIdTypeArray::SafeDownCast(locations);
+    if (typesArray && locationsArray && cells)
+    {
+      ug->SetCells(typesArray, locationsArray, cells);
+    }
+  }
+
+  reader.ReadFieldData(ds->GetPointData());
+  reader.ReadFieldData(ds->GetCellData());
+  reader.ReadFieldData(ds->GetFieldData());
+  if (reader.GetFailed())
+  {
+    vtkGenericWarningMacro("Failed to unmarshal data. Buffer may be truncated.");
+    return NULL;
+  }
+  return ds.GetPointer();
+}
 };
 
 vtkStandardNewMacro(vtkMPIMoveData);
@@ -185,13 +757,89 @@ void vtkMPIMoveData::InitializeForCommunicationForParaView()
 //----------------------------------------------------------------------------
 void vtkMPIMoveData::SetUseZLibCompression(bool b)
 {
-  vtkMPIMoveData::UseZLibCompression = b;
+  vtkMPIMoveData::CompressionMethod = b ? COMPRESSION_ZLIB : COMPRESSION_NONE;
 }
 
 //----------------------------------------------------------------------------
 bool vtkMPIMoveData::GetUseZLibCompression()
 {
-  return vtkMPIMoveData::UseZLibCompression;
+  return vtkMPIMoveData::CompressionMethod == COMPRESSION_ZLIB;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetCompressionMethod(int method)
+{
+  if (method < COMPRESSION_NONE || method > COMPRESSION_CUSTOM)
+  {
+    vtkGenericWarningMacro("Invalid compression method " << method);
+    return;
+  }
+  vtkMPIMoveData::CompressionMethod = method;
+}
+
+//----------------------------------------------------------------------------
+int vtkMPIMoveData::GetCompressionMethod()
+{
+  return vtkMPIMoveData::CompressionMethod;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetCustomCompressorTag(const char* tag)
+{
+  vtkMPIMoveDataCustomCompressorTag = tag ? tag : "";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMPIMoveData::GetCustomCompressorTag()
+{
+  return vtkMPIMoveDataCustomCompressorTag.c_str();
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetAutomaticCompressionBandwidthThreshold(double mbps)
+{
+  vtkMPIMoveData::AutomaticCompressionBandwidthThreshold = mbps;
+}
+
+//----------------------------------------------------------------------------
+double vtkMPIMoveData::GetAutomaticCompressionBandwidthThreshold()
+{
+  return vtkMPIMoveData::AutomaticCompressionBandwidthThreshold;
+}
+
+//----------------------------------------------------------------------------
+int vtkMPIMoveData::GetCompressionMethodForConnection(int connection)
+{
+  if (vtkMPIMoveData::CompressionMethod != COMPRESSION_AUTOMATIC)
+  {
+    return vtkMPIMoveData::CompressionMethod;
+  }
+  if (connection == MPI_CONNECTION)
+  {
+    // MPI interconnects are fast enough that compression only adds latency.
+    return COMPRESSION_NONE;
+  }
+  double bandwidth = vtkMPIMoveData::MeasuredBandwidth[connection];
+  if (bandwidth > 0.0 && bandwidth < vtkMPIMoveData::AutomaticCompressionBandwidthThreshold)
+  {
+    return COMPRESSION_ZLIB;
+  }
+  // Until we have measured the connection, LZ4 is a safe middle ground.
+  return COMPRESSION_LZ4;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::RecordTransfer(int connection, vtkIdType numBytes, double seconds)
+{
+  if (connection < 0 || connection >= NUMBER_OF_CONNECTIONS ||
+    numBytes < vtkMPIMoveDataMinimumSampleSize || seconds <= 0.0)
+  {
+    return;
+  }
+  double sample = numBytes / (seconds * 1024.0 * 1024.0);
+  double& estimate = vtkMPIMoveData::MeasuredBandwidth[connection];
+  // exponential moving average to smooth out noisy samples.
+  estimate = estimate > 0.0 ? 0.75 * estimate + 0.25 * sample : sample;
 }
 
 //----------------------------------------------------------------------------
@@ -792,11 +1440,14 @@ void vtkMPIMoveData::DataServerSendToRenderServer(vtkDataObject* output)
   // int fixme;
   // We might be able to eliminate this marshal.
   this->ClearBuffer();
-  this->MarshalDataToBuffer(output);
+  this->MarshalDataToBuffer(output, RENDER_SERVER_CONNECTION);
 
   com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
   com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
+  double startTime = vtkTimerLog::GetUniversalTime();
   com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
+  vtkMPIMoveData::RecordTransfer(RENDER_SERVER_CONNECTION, this->BufferTotalLength,
+    vtkTimerLog::GetUniversalTime() - startTime);
 }
 
 //-----------------------------------------------------------------------------
@@ -849,10 +1500,13 @@ void vtkMPIMoveData::DataServerZeroSendToRenderServerZero(vtkDataObject* data)
     // int fixme;
     // We might be able to eliminate this marshal.
     this->ClearBuffer();
-    this->MarshalDataToBuffer(data);
+    this->MarshalDataToBuffer(data, RENDER_SERVER_CONNECTION);
     com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
     com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
+    double startTime = vtkTimerLog::GetUniversalTime();
     com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
+    vtkMPIMoveData::RecordTransfer(RENDER_SERVER_CONNECTION, this->BufferTotalLength,
+      vtkTimerLog::GetUniversalTime() - startTime);
     this->ClearBuffer();
   }
 }
@@ -907,11 +1561,14 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
   {
     vtkTimerLog::MarkStartEvent("Dataserver sending to client");
     this->ClearBuffer();
-    this->MarshalDataToBuffer(output);
+    this->MarshalDataToBuffer(output, CLIENT_CONNECTION);
     this->ClientDataServerSocketController->Send(&(this->NumberOfBuffers), 1, 1, 23490);
     this->ClientDataServerSocketController->Send(
       this->BufferLengths, this->NumberOfBuffers, 1, 23491);
+    double startTime = vtkTimerLog::GetUniversalTime();
     this->ClientDataServerSocketController->Send(this->Buffers, this->BufferTotalLength, 1, 23492);
+    vtkMPIMoveData::RecordTransfer(
+      CLIENT_CONNECTION, this->BufferTotalLength, vtkTimerLog::GetUniversalTime() - startTime);
     this->ClearBuffer();
     vtkTimerLog::MarkEndEvent("Dataserver sending to client");
   }
@@ -1026,7 +1683,7 @@ void vtkMPIMoveData::ClearBuffer()
 }
 
 //-----------------------------------------------------------------------------
-void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
+void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data, int connection)
 {
   vtkDataSet* dataSet = vtkDataSet::SafeDownCast(data);
   vtkImageData* imageData = vtkImageData::SafeDownCast(data);
@@ -1039,57 +1696,77 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
     this->NumberOfBuffers = 0;
   }
 
-  // Copy input to isolate reader from the pipeline.
-  vtkDataWriter* writer = vtkGenericDataObjectWriter::New();
-  writer->SetInputData(data);
-  if (imageData)
-  {
-    // We add the image extents to the header, since the writer doesn't preserve
-    // the extents.
-    int* extent = imageData->GetExtent();
-    double* origin = imageData->GetOrigin();
-    std::ostringstream stream;
-    stream << "EXTENT " << extent[0] << " " << extent[1] << " " << extent[2] << " " << extent[3]
-           << " " << extent[4] << " " << extent[5];
-    stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
-    writer->SetHeader(stream.str().c_str());
-  }
-
-  writer->SetFileTypeToBinary();
-  writer->WriteToOutputStringOn();
-  writer->Write();
-
   char* buffer = NULL;
   vtkIdType buffer_length = 0;
 
-  if (vtkMPIMoveData::UseZLibCompression)
-  {
-    vtkTimerLog::MarkStartEvent("Zlib compress");
-    // Use z-lib compression.
-    uLongf out_size = compressBound(writer->GetOutputStringLength());
-    buffer = new char[out_size + 8];
-    memcpy(buffer, "zlib0000", 8);
-
-    compress2(reinterpret_cast<Bytef*>(buffer + 8), &out_size,
-      reinterpret_cast<const Bytef*>(writer->GetOutputString()), writer->GetOutputStringLength(),
-      /* compression_level */ Z_DEFAULT_COMPRESSION);
-    vtkTimerLog::MarkEndEvent("Zlib compress");
-    int in_size = static_cast<int>(writer->GetOutputStringLength());
-    for (int cc = 0; cc < 4; cc++)
+  // Try the native binary encoding first; it avoids the string encode/decode
+  // of the legacy writer for the common polydata/unstructured grid case.
+  char* raw_buffer = NULL;
+  vtkIdType raw_length = 0;
+  vtkTimerLog::MarkStartEvent("Binary marshal");
+  bool marshaled = vtkMPIMoveDataBinaryMarshal(data, raw_buffer, raw_length);
+  vtkTimerLog::MarkEndEvent("Binary marshal");
+  if (!marshaled)
+  {
+    // Copy input to isolate reader from the pipeline.
+    vtkDataWriter* writer = vtkGenericDataObjectWriter::New();
+    writer->SetInputData(data);
+    if (imageData)
     {
-      // the first 4 bytes in the header are "zlib" which helps the receiver
-      // identify that zlib compression has been used.
-      // the next 4 bytes are the original length since zlib doesn't provide
-      // that to the receiver.
-      buffer[4 + cc] = (in_size & 0x0ff);
-      in_size = in_size >> 8;
+      // We add the image extents to the header, since the writer doesn't preserve
+      // the extents.
+      int* extent = imageData->GetExtent();
+      double* origin = imageData->GetOrigin();
+      std::ostringstream stream;
+      stream << "EXTENT " << extent[0] << " " << extent[1] << " " << extent[2] << " " << extent[3]
+             << " " << extent[4] << " " << extent[5];
+      stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
+      writer->SetHeader(stream.str().c_str());
     }
-    buffer_length = out_size + 8;
+
+    writer->SetFileTypeToBinary();
+    writer->WriteToOutputStringOn();
+    writer->Write();
+    raw_length = writer->GetOutputStringLength();
+    raw_buffer = writer->RegisterAndGetOutputString();
+    writer->Delete();
+    writer = 0;
+  }
+
+  vtkSmartPointer<vtkPVDataCompressor> compressor;
+  switch (vtkMPIMoveData::GetCompressionMethodForConnection(connection))
+  {
+    case COMPRESSION_ZLIB:
+      compressor.TakeReference(vtkPVZLibDataCompressor::New());
+      break;
+    case COMPRESSION_LZ4:
+      compressor.TakeReference(vtkPVLZ4DataCompressor::New());
+      break;
+    case COMPRESSION_CUSTOM:
+      compressor.TakeReference(
+        vtkPVDataCompressor::NewCompressor(vtkMPIMoveDataCustomCompressorTag.c_str()));
+      if (!compressor)
+      {
+        vtkWarningMacro("No compressor registered for tag '"
+          << vtkMPIMoveDataCustomCompressorTag << "'. Sending uncompressed data.");
+      }
+      break;
+    default:
+      break;
+  }
+
+  if (compressor)
+  {
+    buffer = compressor->Compress(raw_buffer, raw_length, buffer_length);
+  }
+  if (buffer)
+  {
+    delete[] raw_buffer;
   }
   else
   {
-    buffer_length = writer->GetOutputStringLength();
-    buffer = writer->RegisterAndGetOutputString();
+    buffer_length = raw_length;
+    buffer = raw_buffer;
   }
 
   // Get string.
@@ -1100,9 +1777,6 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
   this->BufferOffsets[0] = 0;
   this->Buffers = buffer;
   this->BufferTotalLength = this->BufferLengths[0];
-
-  writer->Delete();
-  writer = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -1123,8 +1797,23 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
     vtkIdType bufferLength = this->BufferLengths[idx];
 
     char* realBuffer = 0;
-    if (bufferLength > 4 && strncmp(bufferArray, "zlib", 4) == 0)
+    vtkSmartPointer<vtkPVDataCompressor> decompressor;
+    decompressor.TakeReference(vtkPVDataCompressor::NewForBuffer(bufferArray, bufferLength));
+    if (decompressor)
     {
+      vtkIdType uncompressed_length = 0;
+      realBuffer = decompressor->Decompress(bufferArray, bufferLength, uncompressed_length);
+      if (realBuffer == NULL)
+      {
+        vtkErrorMacro("Failed to decompress received data.");
+        continue;
+      }
+      bufferArray = realBuffer;
+      bufferLength = uncompressed_length;
+    }
+    else if (bufferLength > 4 && strncmp(bufferArray, "zlib", 4) == 0)
+    {
+      // data compressed by older versions of vtkMPIMoveData.
       // sender used zlib compression. Decompress it.
       vtkIdType compressed_length = bufferLength - 8; // remove the zlib header.
       vtkIdType uncompressed_length = 0;
@@ -1145,6 +1834,27 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
       bufferLength = uncompressed_length;
     }
 
+    if (vtkMPIMoveDataIsBinaryMarshaled(bufferArray, bufferLength))
+    {
+      vtkTimerLog::MarkStartEvent("Binary unmarshal");
+      vtkSmartPointer<vtkDataObject> piece =
+        vtkMPIMoveDataBinaryUnmarshal(bufferArray, bufferLength);
+      vtkTimerLog::MarkEndEvent("Binary unmarshal");
+      if (piece)
+      {
+        // reconstructing data distributted on MPI node, so global ids are valid
+        unsetGlobalIdsAttribute(piece);
+        pieces.push_back(piece);
+      }
+      else
+      {
+        vtkErrorMacro("Failed to unmarshal received data.");
+      }
+      delete[] realBuffer;
+      realBuffer = 0;
+      continue;
+    }
+
     // Setup a reader.
     vtkDataReader* reader = vtkGenericDataObjectReader::New();
     reader->ReadFromInputStringOn();
@@ -21,6 +21,12 @@
  * processes. It can redistributed polydata from M to N processors.
  * Update: This filter can now support delivering vtkUniformGridAMR datasets in
  * PASS_THROUGH and/or COLLECT modes.
+ *
+ * vtkPolyData and vtkUnstructuredGrid pieces are marshaled using a native
+ * binary encoding that copies the raw array buffers into the message instead
+ * of going through the legacy VTK writer/reader. Other data types, and
+ * datasets with arrays that cannot be sent as contiguous blocks, use the
+ * legacy writer.
 */
 
 #ifndef vtkMPIMoveData_h
@@ -108,11 +114,50 @@ public:
    * When set to true, zlib compression is used. False by default.
    * This value has any effect only on the data-sender processes. The receiver
    * always checks the received data to see if zlib decompression is required.
+   * This is a shortcut for SetCompressionMethod(COMPRESSION_ZLIB) or
+   * SetCompressionMethod(COMPRESSION_NONE).
    */
   static void SetUseZLibCompression(bool b);
   static bool GetUseZLibCompression();
   //@}
 
+  enum CompressionMethods
+  {
+    COMPRESSION_NONE = 0,
+    COMPRESSION_ZLIB = 1,
+    COMPRESSION_LZ4 = 2,
+    COMPRESSION_AUTOMATIC = 3,
+    COMPRESSION_CUSTOM = 4
+  };
+
+  //@{
+  /**
+   * Select the compressor used for delivered data. COMPRESSION_NONE by
+   * default. Like UseZLibCompression, this only affects the sender; the
+   * receiver detects the compressor from the data itself.
+   *
+   * COMPRESSION_AUTOMATIC picks the codec per connection: MPI transfers
+   * within a server are not compressed, while socket connections use zlib
+   * when the measured bandwidth of previous deliveries over that connection
+   * is below AutomaticCompressionBandwidthThreshold and LZ4 otherwise.
+   * COMPRESSION_CUSTOM uses the vtkPVDataCompressor registered under
+   * CustomCompressorTag.
+   */
+  static void SetCompressionMethod(int method);
+  static int GetCompressionMethod();
+  static void SetCustomCompressorTag(const char* tag);
+  static const char* GetCustomCompressorTag();
+  //@}
+
+  //@{
+  /**
+   * Bandwidth, in MB/s, below which COMPRESSION_AUTOMATIC prefers zlib over
+   * LZ4. Default is 100 MB/s.
+   */
+  static void SetAutomaticCompressionBandwidthThreshold(double mbps);
+  static double GetAutomaticCompressionBandwidthThreshold();
+  //@}
+
   /**
    * vtkMPIMoveData doesn't necessarily generate a valid output data on all the
    * involved processes (depending on the MoveMode and Server ivars). This
@@ -170,10 +215,29 @@ protected:
   char* Buffers;
   vtkIdType BufferTotalLength;
 
+  enum Connections
+  {
+    MPI_CONNECTION = 0,
+    CLIENT_CONNECTION = 1,
+    RENDER_SERVER_CONNECTION = 2,
+    NUMBER_OF_CONNECTIONS = 3
+  };
+
   void ClearBuffer();
-  void MarshalDataToBuffer(vtkDataObject* data);
+  void MarshalDataToBuffer(vtkDataObject* data, int connection = MPI_CONNECTION);
   void ReconstructDataFromBuffer(vtkDataObject* data);
 
+  /**
+   * Returns the compression method to use for data sent over `connection`.
+   */
+  static int GetCompressionMethodForConnection(int connection);
+
+  /**
+   * Updates the bandwidth estimate for `connection` used by
+   * COMPRESSION_AUTOMATIC.
+   */
+  static void RecordTransfer(int connection, vtkIdType numBytes, double seconds);
+
   int MoveMode;
   int Server;
 
@@ -195,7 +259,9 @@ private:
   vtkMPIMoveData(const vtkMPIMoveData&) = delete;
   void operator=(const vtkMPIMoveData&) = delete;
 
-  static bool UseZLibCompression;
+  static int CompressionMethod;
+  static double AutomaticCompressionBandwidthThreshold;
+  static double MeasuredBandwidth[NUMBER_OF_CONNECTIONS];
 };
 
 #endif
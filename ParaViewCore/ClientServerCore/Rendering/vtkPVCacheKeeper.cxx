@@ -23,21 +23,55 @@
 #include "vtkProcessModule.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
 #include <map>
+#include <vector>
 //----------------------------------------------------------------------------
-class vtkPVCacheKeeper::vtkCacheMap : public std::map<double, vtkSmartPointer<vtkDataObject> >
+class vtkPVCacheKeeper::vtkCacheMap
 {
 public:
+  struct vtkItem
+  {
+    vtkSmartPointer<vtkDataObject> Data;
+    unsigned long Size; // in kbytes.
+    vtkTypeUInt64 LastAccess;
+  };
+  typedef std::map<double, vtkItem> MapType;
+  MapType Items;
+  vtkTypeUInt64 AccessCounter;
+
+  vtkCacheMap()
+    : AccessCounter(0)
+  {
+  }
+
   unsigned long GetActualMemorySize()
   {
     unsigned long actual_size = 0;
-    vtkCacheMap::iterator iter;
-    for (iter = this->begin(); iter != this->end(); ++iter)
+    MapType::iterator iter;
+    for (iter = this->Items.begin(); iter != this->Items.end(); ++iter)
     {
-      actual_size += iter->second.GetPointer()->GetActualMemorySize();
+      actual_size += iter->second.Size;
     }
     return actual_size;
   }
+
+  static bool IsLessRecentlyUsed(MapType::iterator a, MapType::iterator b)
+  {
+    return a->second.LastAccess < b->second.LastAccess;
+  }
+
+  // Returns the items, least recently used first.
+  std::vector<MapType::iterator> GetLeastRecentlyUsedOrder()
+  {
+    std::vector<MapType::iterator> order;
+    for (MapType::iterator iter = this->Items.begin(); iter != this->Items.end(); ++iter)
+    {
+      order.push_back(iter);
+    }
+    std::sort(order.begin(), order.end(), vtkCacheMap::IsLessRecentlyUsed);
+    return order;
+  }
 };
 
 vtkStandardNewMacro(vtkPVCacheKeeper);
@@ -73,7 +107,7 @@ void vtkPVCacheKeeper::RemoveAllCaches()
 {
   // cout << this << " RemoveAllCaches" << endl;
   unsigned long freed_size = this->Cache->GetActualMemorySize();
-  this->Cache->clear();
+  this->Cache->Items.clear();
   if (freed_size > 0 && this->CacheSizeKeeper)
   {
     // Tell the cache size keeper about the newly freed memory size.
@@ -86,28 +120,83 @@ void vtkPVCacheKeeper::RemoveAllCaches()
 //----------------------------------------------------------------------------
 bool vtkPVCacheKeeper::IsCached(double cacheTime)
 {
-  vtkPVCacheKeeper::vtkCacheMap::iterator iter = this->Cache->find(cacheTime);
-  return (iter != this->Cache->end());
+  return this->Cache->Items.find(cacheTime) != this->Cache->Items.end();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkPVCacheKeeper::GetCacheSize()
+{
+  return this->Cache->GetActualMemorySize();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVCacheKeeper::GetNumberOfCachedTimeSteps()
+{
+  return static_cast<int>(this->Cache->Items.size());
 }
 
 //----------------------------------------------------------------------------
 bool vtkPVCacheKeeper::SaveData(vtkDataObject* output)
 {
-  if (!this->CacheSizeKeeper || !this->CacheSizeKeeper->GetCacheFull())
+  vtkSmartPointer<vtkDataObject> cache;
+  cache.TakeReference(output->NewInstance());
+  cache->ShallowCopy(output);
+  const unsigned long size = cache->GetActualMemorySize();
+
+  unsigned long freed_size = 0;
+  const bool cache_full = this->CacheSizeKeeper && this->CacheSizeKeeper->GetCacheFull();
+  if (cache_full)
   {
-    vtkSmartPointer<vtkDataObject> cache;
-    cache.TakeReference(output->NewInstance());
-    cache->ShallowCopy(output);
-    (*this->Cache)[this->CacheTime] = cache;
+    // Make room by evicting least recently used time steps. The cache
+    // fullness and the number of steps to evict are synchronized among all
+    // processes by vtkPVView::Update, and all processes see the same sequence
+    // of cache times, so they all evict the same steps and IsCached() answers
+    // stay consistent. No communication happens here since the pipeline does
+    // not necessarily execute on all processes.
+    std::vector<vtkCacheMap::MapType::iterator> order = this->Cache->GetLeastRecentlyUsedOrder();
+    if (order.empty())
+    {
+      return false;
+    }
+
+    // Report how many steps this process needed to evict for the data to fit,
+    // so that the next updates evict enough of them. Until then, the cache may
+    // exceed its limit by the size of a time step.
+    int needed = 0;
+    unsigned long needed_size = 0;
+    while (needed_size < size && needed < static_cast<int>(order.size()))
+    {
+      needed_size += order[needed++]->second.Size;
+    }
+    this->CacheSizeKeeper->RequestEvictionCount(needed);
 
-    if (this->CacheSizeKeeper)
+    int count = std::min(
+      std::max(this->CacheSizeKeeper->GetEvictionCount(), 1), static_cast<int>(order.size()));
+    for (int cc = 0; cc < count; ++cc)
+    {
+      freed_size += order[cc]->second.Size;
+      this->Cache->Items.erase(order[cc]);
+    }
+  }
+
+  vtkCacheMap::vtkItem& item = this->Cache->Items[this->CacheTime];
+  item.Data = cache;
+  item.Size = size;
+  item.LastAccess = ++this->Cache->AccessCounter;
+
+  if (this->CacheSizeKeeper)
+  {
+    // Register used cache size.
+    if (cache_full)
+    {
+      this->CacheSizeKeeper->ReplaceCacheSize(freed_size, item.Size);
+    }
+    else
     {
-      // Register used cache size.
-      this->CacheSizeKeeper->AddCacheSize(cache->GetActualMemorySize());
+      this->CacheSizeKeeper->AddCacheSize(item.Size);
     }
-    return true;
   }
-  return false;
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -162,7 +251,9 @@ int vtkPVCacheKeeper::RequestData(vtkInformation* vtkNotUsed(reqInfo),
   {
     if (this->IsCached(this->CacheTime))
     {
-      output->ShallowCopy((*this->Cache)[this->CacheTime]);
+      vtkCacheMap::vtkItem& item = this->Cache->Items[this->CacheTime];
+      item.LastAccess = ++this->Cache->AccessCounter;
+      output->ShallowCopy(item.Data);
       // cout << this << " using Cache: " << this->CacheTime << endl;
       vtkPVCacheKeeper::CacheHit++;
     }
@@ -213,4 +304,8 @@ int vtkPVCacheKeeper::GetCacheSkips()
 void vtkPVCacheKeeper::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CachingEnabled: " << this->CachingEnabled << endl;
+  os << indent << "CacheTime: " << this->CacheTime << endl;
+  os << indent << "NumberOfCachedTimeSteps: " << this->GetNumberOfCachedTimeSteps() << endl;
+  os << indent << "CacheSize: " << this->GetCacheSize() << endl;
 }
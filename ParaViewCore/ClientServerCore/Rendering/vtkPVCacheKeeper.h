@@ -22,6 +22,11 @@
  * then this filter shuts the update request, otherwise propagates the update
  * and then cache the result for later use.  The current time step is set using
  * SetCacheTime().
+ *
+ * When the cache is full (as reported by vtkCacheSizeKeeper), saving a new
+ * time step evicts the least recently used time steps cached by this filter,
+ * as many as vtkCacheSizeKeeper::GetEvictionCount(). If this filter has
+ * nothing cached, the new time step is not cached.
  * @sa
  * vtkPVCacheKeeperPipeline
 */
@@ -62,6 +67,16 @@ public:
   virtual bool IsCached(double cacheTime);
   virtual bool IsCached() { return this->IsCached(this->CacheTime); }
 
+  /**
+   * Returns the memory used by the data cached by this filter (in kbytes).
+   */
+  unsigned long GetCacheSize();
+
+  /**
+   * Returns the number of time steps cached by this filter.
+   */
+  int GetNumberOfCachedTimeSteps();
+
   //@{
   /**
    * Get/Set if caching is enabled. Default is true.
@@ -104,7 +119,10 @@ protected:
 
   /**
    * Called to save the data in cache. Returns true if data is saved otherwise
-   * false.
+   * false. If the cache is full, the number of least recently used time steps
+   * given by vtkCacheSizeKeeper::GetEvictionCount() are evicted first, and the
+   * number of steps that had to be evicted for the data to fit is reported to
+   * the vtkCacheSizeKeeper. This does not communicate with other processes.
    */
   virtual bool SaveData(vtkDataObject*);
 
@@ -15,12 +15,14 @@
 =========================================================================*/
 #include "vtkPVClientServerSynchronizedRenderers.h"
 
+#include "vtkDeltaImageCompressor.h"
 #include "vtkLZ4Compressor.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkOpenGLRenderer.h"
 #include "vtkPVConfig.h"
 #include "vtkSquirtCompressor.h"
+#include "vtkTiledSquirtCompressor.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkZlibImageCompressor.h"
 #ifdef PARAVIEW_ENABLE_NVPIPE
@@ -174,14 +176,23 @@ void vtkPVClientServerSynchronizedRenderers::ConfigureCompressor(const char* str
   std::istringstream iss(stream);
   std::string className;
   iss >> className;
-  // Allocate the desired compressor unless we have one in hand.
-  if (this->Compressor == nullptr || !this->Compressor->IsA(className.c_str()))
+  // Allocate the desired compressor unless we have one in hand. Compare class
+  // names exactly since compressors may subclass one another.
+  if (this->Compressor == nullptr || className != this->Compressor->GetClassName())
   {
     vtkImageCompressor* comp = 0;
     if (className == "vtkSquirtCompressor")
     {
       comp = vtkSquirtCompressor::New();
     }
+    else if (className == "vtkDeltaImageCompressor")
+    {
+      comp = vtkDeltaImageCompressor::New();
+    }
+    else if (className == "vtkTiledSquirtCompressor")
+    {
+      comp = vtkTiledSquirtCompressor::New();
+    }
     else if (className == "vtkZlibImageCompressor")
     {
       comp = vtkZlibImageCompressor::New();
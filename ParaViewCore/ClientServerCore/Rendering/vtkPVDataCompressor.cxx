@@ -0,0 +1,344 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDataCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVDataCompressor.h"
+
+#include "vtkPVLZ4DataCompressor.h"
+#include "vtkPVZLibDataCompressor.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Compressed buffer layout (all integers little-endian):
+//   char[4]  tag
+//   uint32   format version
+//   int64    total uncompressed length
+//   int64    number of chunks
+//   int64[2] (uncompressed, compressed) length of each chunk
+//   ...      compressed chunks, back to back.
+const vtkTypeUInt32 vtkPVDataCompressorVersion = 1;
+const size_t vtkPVDataCompressorHeaderSize = 24;
+
+void vtkEncodeInt(char* dest, vtkTypeUInt64 value, int numBytes)
+{
+  for (int cc = 0; cc < numBytes; ++cc)
+  {
+    dest[cc] = static_cast<char>(value & 0xff);
+    value >>= 8;
+  }
+}
+
+vtkTypeUInt64 vtkDecodeInt(const char* src, int numBytes)
+{
+  vtkTypeUInt64 value = 0;
+  for (int cc = numBytes - 1; cc >= 0; --cc)
+  {
+    value = (value << 8) | static_cast<unsigned char>(src[cc]);
+  }
+  return value;
+}
+
+typedef std::map<std::string, vtkPVDataCompressor::NewFunctionType> vtkPVDataCompressorRegistry;
+
+vtkPVDataCompressor* vtkNewZLibDataCompressor()
+{
+  return vtkPVZLibDataCompressor::New();
+}
+
+vtkPVDataCompressor* vtkNewLZ4DataCompressor()
+{
+  return vtkPVLZ4DataCompressor::New();
+}
+
+vtkPVDataCompressorRegistry& vtkGetRegistry()
+{
+  static vtkPVDataCompressorRegistry registry;
+  if (registry.empty())
+  {
+    registry["pvzl"] = vtkNewZLibDataCompressor;
+    registry["pvl4"] = vtkNewLZ4DataCompressor;
+  }
+  return registry;
+}
+
+class vtkCompressChunksFunctor
+{
+public:
+  vtkPVDataCompressor* Self;
+  const char* Input;
+  vtkIdType InputLength;
+  vtkIdType ChunkSize;
+  char* Output;
+  const std::vector<size_t>* OutputOffsets;
+  std::vector<size_t>* CompressedLengths;
+  size_t (*Compress)(vtkPVDataCompressor*, const char*, size_t, char*, size_t);
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      const vtkIdType start = chunk * this->ChunkSize;
+      const size_t length =
+        static_cast<size_t>(std::min(this->ChunkSize, this->InputLength - start));
+      const size_t capacity = (*this->OutputOffsets)[chunk + 1] - (*this->OutputOffsets)[chunk];
+      (*this->CompressedLengths)[chunk] = (*this->Compress)(this->Self, this->Input + start,
+        length, this->Output + (*this->OutputOffsets)[chunk], capacity);
+    }
+  }
+};
+
+class vtkDecompressChunksFunctor
+{
+public:
+  vtkPVDataCompressor* Self;
+  const char* Input;
+  char* Output;
+  const std::vector<size_t>* InputOffsets;
+  const std::vector<size_t>* OutputOffsets;
+  std::vector<unsigned char>* Status;
+  bool (*Decompress)(vtkPVDataCompressor*, const char*, size_t, char*, size_t);
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      const std::vector<size_t>& inOffsets = *this->InputOffsets;
+      const std::vector<size_t>& outOffsets = *this->OutputOffsets;
+      bool status = (*this->Decompress)(this->Self, this->Input + inOffsets[chunk],
+        inOffsets[chunk + 1] - inOffsets[chunk], this->Output + outOffsets[chunk],
+        outOffsets[chunk + 1] - outOffsets[chunk]);
+      (*this->Status)[chunk] = status ? 1 : 0;
+    }
+  }
+};
+}
+
+//----------------------------------------------------------------------------
+// Trampolines giving the functors access to the protected chunk codecs.
+class vtkPVDataCompressorInternals
+{
+public:
+  static size_t CompressChunk(
+    vtkPVDataCompressor* self, const char* input, size_t length, char* output, size_t capacity)
+  {
+    return self->CompressChunk(input, length, output, capacity);
+  }
+  static bool DecompressChunk(vtkPVDataCompressor* self, const char* input, size_t length,
+    char* output, size_t outputLength)
+  {
+    return self->DecompressChunk(input, length, output, outputLength);
+  }
+};
+
+//----------------------------------------------------------------------------
+vtkPVDataCompressor::vtkPVDataCompressor()
+  : ChunkSize(1 << 20)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVDataCompressor::~vtkPVDataCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+char* vtkPVDataCompressor::Compress(const char* input, vtkIdType length, vtkIdType& outputLength)
+{
+  outputLength = 0;
+  if (input == NULL || length < 0)
+  {
+    return NULL;
+  }
+
+  const char* tag = this->GetTag();
+  assert(tag != NULL && strlen(tag) == 4);
+
+  const vtkIdType numChunks = (length + this->ChunkSize - 1) / this->ChunkSize;
+  const size_t tableSize = vtkPVDataCompressorHeaderSize + 16 * static_cast<size_t>(numChunks);
+
+  // Lay out the worst case size of every chunk so that all chunks can be
+  // compressed concurrently into a single allocation.
+  std::vector<size_t> offsets(numChunks + 1);
+  offsets[0] = tableSize;
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+  {
+    const vtkIdType chunkLength = std::min(this->ChunkSize, length - chunk * this->ChunkSize);
+    offsets[chunk + 1] =
+      offsets[chunk] + this->GetCompressBound(static_cast<size_t>(chunkLength));
+  }
+
+  char* output = new char[offsets[numChunks]];
+  std::vector<size_t> compressedLengths(numChunks, 0);
+
+  vtkTimerLog::MarkStartEvent("vtkPVDataCompressor::Compress");
+  vtkCompressChunksFunctor functor;
+  functor.Self = this;
+  functor.Input = input;
+  functor.InputLength = length;
+  functor.ChunkSize = this->ChunkSize;
+  functor.Output = output;
+  functor.OutputOffsets = &offsets;
+  functor.CompressedLengths = &compressedLengths;
+  functor.Compress = &vtkPVDataCompressorInternals::CompressChunk;
+  vtkSMPTools::For(0, numChunks, 1, functor);
+  vtkTimerLog::MarkEndEvent("vtkPVDataCompressor::Compress");
+
+  // Write the header and chunk table, then pack the compressed chunks.
+  memcpy(output, tag, 4);
+  vtkEncodeInt(output + 4, vtkPVDataCompressorVersion, 4);
+  vtkEncodeInt(output + 8, static_cast<vtkTypeUInt64>(length), 8);
+  vtkEncodeInt(output + 16, static_cast<vtkTypeUInt64>(numChunks), 8);
+  size_t packedEnd = tableSize;
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+  {
+    if (compressedLengths[chunk] == 0)
+    {
+      vtkErrorMacro("Failed to compress chunk " << chunk << ".");
+      delete[] output;
+      return NULL;
+    }
+    const vtkIdType chunkLength = std::min(this->ChunkSize, length - chunk * this->ChunkSize);
+    char* entry = output + vtkPVDataCompressorHeaderSize + 16 * chunk;
+    vtkEncodeInt(entry, static_cast<vtkTypeUInt64>(chunkLength), 8);
+    vtkEncodeInt(entry + 8, static_cast<vtkTypeUInt64>(compressedLengths[chunk]), 8);
+    if (packedEnd != offsets[chunk])
+    {
+      memmove(output + packedEnd, output + offsets[chunk], compressedLengths[chunk]);
+    }
+    packedEnd += compressedLengths[chunk];
+  }
+
+  outputLength = static_cast<vtkIdType>(packedEnd);
+  return output;
+}
+
+//----------------------------------------------------------------------------
+char* vtkPVDataCompressor::Decompress(
+  const char* input, vtkIdType length, vtkIdType& outputLength)
+{
+  outputLength = 0;
+  if (input == NULL || length < static_cast<vtkIdType>(vtkPVDataCompressorHeaderSize) ||
+    strncmp(input, this->GetTag(), 4) != 0)
+  {
+    vtkErrorMacro("Buffer was not compressed using " << this->GetClassName() << ".");
+    return NULL;
+  }
+  if (vtkDecodeInt(input + 4, 4) != vtkPVDataCompressorVersion)
+  {
+    vtkErrorMacro("Unsupported compressed buffer version.");
+    return NULL;
+  }
+
+  const vtkIdType totalLength = static_cast<vtkIdType>(vtkDecodeInt(input + 8, 8));
+  const vtkIdType numChunks = static_cast<vtkIdType>(vtkDecodeInt(input + 16, 8));
+  const size_t tableSize = vtkPVDataCompressorHeaderSize + 16 * static_cast<size_t>(numChunks);
+  if (numChunks < 0 || totalLength < 0 || tableSize > static_cast<size_t>(length))
+  {
+    vtkErrorMacro("Corrupt compressed buffer header.");
+    return NULL;
+  }
+
+  std::vector<size_t> inputOffsets(numChunks + 1);
+  std::vector<size_t> outputOffsets(numChunks + 1);
+  inputOffsets[0] = tableSize;
+  outputOffsets[0] = 0;
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+  {
+    const char* entry = input + vtkPVDataCompressorHeaderSize + 16 * chunk;
+    outputOffsets[chunk + 1] = outputOffsets[chunk] + vtkDecodeInt(entry, 8);
+    inputOffsets[chunk + 1] = inputOffsets[chunk] + vtkDecodeInt(entry + 8, 8);
+  }
+  if (inputOffsets[numChunks] > static_cast<size_t>(length) ||
+    outputOffsets[numChunks] != static_cast<size_t>(totalLength))
+  {
+    vtkErrorMacro("Corrupt compressed buffer chunk table.");
+    return NULL;
+  }
+
+  char* output = new char[totalLength];
+  std::vector<unsigned char> status(numChunks, 0);
+
+  vtkTimerLog::MarkStartEvent("vtkPVDataCompressor::Decompress");
+  vtkDecompressChunksFunctor functor;
+  functor.Self = this;
+  functor.Input = input;
+  functor.Output = output;
+  functor.InputOffsets = &inputOffsets;
+  functor.OutputOffsets = &outputOffsets;
+  functor.Status = &status;
+  functor.Decompress = &vtkPVDataCompressorInternals::DecompressChunk;
+  vtkSMPTools::For(0, numChunks, 1, functor);
+  vtkTimerLog::MarkEndEvent("vtkPVDataCompressor::Decompress");
+
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+  {
+    if (status[chunk] == 0)
+    {
+      vtkErrorMacro("Failed to decompress chunk " << chunk << ".");
+      delete[] output;
+      return NULL;
+    }
+  }
+
+  outputLength = totalLength;
+  return output;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataCompressor::RegisterCompressor(const char* tag, NewFunctionType newFunction)
+{
+  if (tag == NULL || strlen(tag) != 4)
+  {
+    vtkGenericWarningMacro("Compressor tags must be exactly 4 characters long.");
+    return;
+  }
+  vtkGetRegistry()[tag] = newFunction;
+}
+
+//----------------------------------------------------------------------------
+vtkPVDataCompressor* vtkPVDataCompressor::NewCompressor(const char* tag)
+{
+  if (tag == NULL)
+  {
+    return NULL;
+  }
+  vtkPVDataCompressorRegistry& registry = vtkGetRegistry();
+  vtkPVDataCompressorRegistry::const_iterator iter = registry.find(tag);
+  return (iter != registry.end() && iter->second) ? (*iter->second)() : NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkPVDataCompressor* vtkPVDataCompressor::NewForBuffer(const char* buffer, vtkIdType length)
+{
+  if (buffer == NULL || length < static_cast<vtkIdType>(vtkPVDataCompressorHeaderSize))
+  {
+    return NULL;
+  }
+  return vtkPVDataCompressor::NewCompressor(std::string(buffer, 4).c_str());
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ChunkSize: " << this->ChunkSize << endl;
+}
@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDataCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVDataCompressor
+ * @brief   abstract base class for compressors used for data delivery.
+ *
+ * vtkPVDataCompressor compresses and decompresses opaque byte buffers such as
+ * the marshaled pieces exchanged by vtkMPIMoveData. The input is split into
+ * chunks of ChunkSize bytes which are compressed and decompressed
+ * independently and in parallel using vtkSMPTools. Subclasses only need to
+ * implement the per-chunk codec.
+ *
+ * Every compressed buffer starts with a four character tag identifying the
+ * codec, so the receiver can pick the right decompressor using
+ * NewForBuffer(). Additional codecs can be made available, for example by
+ * plugins, using RegisterCompressor().
+ *
+ * @sa vtkPVLZ4DataCompressor vtkPVZLibDataCompressor
+*/
+
+#ifndef vtkPVDataCompressor_h
+#define vtkPVDataCompressor_h
+
+#include "vtkObject.h"
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+
+#include <cstddef> // for size_t
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVDataCompressor : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkPVDataCompressor, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Size, in bytes, of the chunks that are compressed independently. Larger
+   * chunks give slightly better ratios, smaller chunks expose more
+   * parallelism. Default is 1 MiB, maximum is 1 GiB.
+   */
+  vtkSetClampMacro(ChunkSize, vtkIdType, 1024, 1073741824);
+  vtkGetMacro(ChunkSize, vtkIdType);
+  //@}
+
+  /**
+   * Compresses `length` bytes from `input`. Returns a buffer allocated with
+   * new[] that the caller must delete[], and sets `outputLength`. Returns NULL
+   * on failure.
+   */
+  char* Compress(const char* input, vtkIdType length, vtkIdType& outputLength);
+
+  /**
+   * Decompresses a buffer produced by Compress() on a compressor of the same
+   * type. Returns a buffer allocated with new[] that the caller must delete[],
+   * and sets `outputLength`. Returns NULL on failure.
+   */
+  char* Decompress(const char* input, vtkIdType length, vtkIdType& outputLength);
+
+  /**
+   * Returns the four character tag written at the start of compressed
+   * buffers.
+   */
+  virtual const char* GetTag() = 0;
+
+  typedef vtkPVDataCompressor* (*NewFunctionType)();
+
+  /**
+   * Registers a compressor under the given four character tag. Built-in
+   * compressors are registered automatically. Registering an existing tag
+   * replaces the previous entry.
+   */
+  static void RegisterCompressor(const char* tag, NewFunctionType newFunction);
+
+  /**
+   * Creates a new instance of the compressor registered under `tag`, or NULL
+   * if there is none.
+   */
+  static vtkPVDataCompressor* NewCompressor(const char* tag);
+
+  /**
+   * Creates a new instance of the compressor that produced `buffer`, or NULL
+   * if the buffer was not produced by a registered compressor.
+   */
+  static vtkPVDataCompressor* NewForBuffer(const char* buffer, vtkIdType length);
+
+protected:
+  vtkPVDataCompressor();
+  ~vtkPVDataCompressor() override;
+
+  /**
+   * Returns the maximum compressed size of a chunk of `length` bytes.
+   */
+  virtual size_t GetCompressBound(size_t length) = 0;
+
+  /**
+   * Compresses one chunk into `output`, which can hold `capacity` bytes.
+   * Returns the compressed size or 0 on failure. Called concurrently from
+   * multiple threads.
+   */
+  virtual size_t CompressChunk(
+    const char* input, size_t length, char* output, size_t capacity) = 0;
+
+  /**
+   * Decompresses one chunk into `output`, which is exactly `outputLength`
+   * bytes long. Called concurrently from multiple threads.
+   */
+  virtual bool DecompressChunk(
+    const char* input, size_t length, char* output, size_t outputLength) = 0;
+
+  vtkIdType ChunkSize;
+
+private:
+  friend class vtkPVDataCompressorInternals;
+
+  vtkPVDataCompressor(const vtkPVDataCompressor&) = delete;
+  void operator=(const vtkPVDataCompressor&) = delete;
+};
+
+#endif
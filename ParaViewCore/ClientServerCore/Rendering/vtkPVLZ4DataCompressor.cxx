@@ -0,0 +1,67 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLZ4DataCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVLZ4DataCompressor.h"
+
+#include "vtkObjectFactory.h"
+
+#include "vtk_lz4.h"
+
+vtkStandardNewMacro(vtkPVLZ4DataCompressor);
+//----------------------------------------------------------------------------
+vtkPVLZ4DataCompressor::vtkPVLZ4DataCompressor()
+  : Acceleration(1)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVLZ4DataCompressor::~vtkPVLZ4DataCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPVLZ4DataCompressor::GetCompressBound(size_t length)
+{
+  // chunks are limited to what LZ4 can handle by ChunkSize.
+  return static_cast<size_t>(LZ4_compressBound(static_cast<int>(length)));
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPVLZ4DataCompressor::CompressChunk(
+  const char* input, size_t length, char* output, size_t capacity)
+{
+  if (length > static_cast<size_t>(LZ4_MAX_INPUT_SIZE))
+  {
+    return 0;
+  }
+  int result = LZ4_compress_fast(input, output, static_cast<int>(length),
+    static_cast<int>(capacity), this->Acceleration);
+  return result > 0 ? static_cast<size_t>(result) : 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVLZ4DataCompressor::DecompressChunk(
+  const char* input, size_t length, char* output, size_t outputLength)
+{
+  int result = LZ4_decompress_safe(
+    input, output, static_cast<int>(length), static_cast<int>(outputLength));
+  return result >= 0 && static_cast<size_t>(result) == outputLength;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLZ4DataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Acceleration: " << this->Acceleration << endl;
+}
@@ -0,0 +1,65 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLZ4DataCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVLZ4DataCompressor
+ * @brief   vtkPVDataCompressor using LZ4.
+ *
+ * vtkPVLZ4DataCompressor provides fast lossless compression with modest
+ * ratios. It is well suited to high bandwidth connections where zlib would
+ * cost more time than it saves on the wire.
+*/
+
+#ifndef vtkPVLZ4DataCompressor_h
+#define vtkPVLZ4DataCompressor_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+#include "vtkPVDataCompressor.h"
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVLZ4DataCompressor : public vtkPVDataCompressor
+{
+public:
+  static vtkPVLZ4DataCompressor* New();
+  vtkTypeMacro(vtkPVLZ4DataCompressor, vtkPVDataCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * LZ4 acceleration factor. Higher values are faster but compress less.
+   * Default is 1.
+   */
+  vtkSetClampMacro(Acceleration, int, 1, 65537);
+  vtkGetMacro(Acceleration, int);
+  //@}
+
+  const char* GetTag() VTK_OVERRIDE { return "pvl4"; }
+
+protected:
+  vtkPVLZ4DataCompressor();
+  ~vtkPVLZ4DataCompressor() override;
+
+  size_t GetCompressBound(size_t length) VTK_OVERRIDE;
+  size_t CompressChunk(
+    const char* input, size_t length, char* output, size_t capacity) VTK_OVERRIDE;
+  bool DecompressChunk(
+    const char* input, size_t length, char* output, size_t outputLength) VTK_OVERRIDE;
+
+  int Acceleration;
+
+private:
+  vtkPVLZ4DataCompressor(const vtkPVLZ4DataCompressor&) = delete;
+  void operator=(const vtkPVLZ4DataCompressor&) = delete;
+};
+
+#endif
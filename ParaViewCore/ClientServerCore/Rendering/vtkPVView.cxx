@@ -304,6 +304,20 @@ void vtkPVView::Update()
     }
     this->SynchronizedWindows->SynchronizeSize(cache_full);
     cacheSizeKeeper->SetCacheFull(cache_full > 0);
+
+    // Caches evict time steps while the pipeline executes, where processes
+    // cannot communicate, so the number of steps to evict is agreed on here.
+    vtkIdType eviction_count = cacheSizeKeeper->GetRequestedEvictionCount();
+    this->SynchronizedWindows->Reduce(eviction_count, vtkPVSynchronizedRenderWindows::MAX_OP);
+    cacheSizeKeeper->ResetRequestedEvictionCount();
+    if (cache_full == 0)
+    {
+      cacheSizeKeeper->SetEvictionCount(1);
+    }
+    else if (eviction_count > 0)
+    {
+      cacheSizeKeeper->SetEvictionCount(static_cast<int>(eviction_count));
+    }
   }
 
   this->CallProcessViewRequest(
@@ -0,0 +1,64 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVZLibDataCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVZLibDataCompressor.h"
+
+#include "vtkObjectFactory.h"
+
+#include "vtk_zlib.h"
+
+vtkStandardNewMacro(vtkPVZLibDataCompressor);
+//----------------------------------------------------------------------------
+vtkPVZLibDataCompressor::vtkPVZLibDataCompressor()
+  : CompressionLevel(6)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVZLibDataCompressor::~vtkPVZLibDataCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPVZLibDataCompressor::GetCompressBound(size_t length)
+{
+  return static_cast<size_t>(compressBound(static_cast<uLong>(length)));
+}
+
+//----------------------------------------------------------------------------
+size_t vtkPVZLibDataCompressor::CompressChunk(
+  const char* input, size_t length, char* output, size_t capacity)
+{
+  uLongf outSize = static_cast<uLongf>(capacity);
+  int result = compress2(reinterpret_cast<Bytef*>(output), &outSize,
+    reinterpret_cast<const Bytef*>(input), static_cast<uLong>(length), this->CompressionLevel);
+  return result == Z_OK ? static_cast<size_t>(outSize) : 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVZLibDataCompressor::DecompressChunk(
+  const char* input, size_t length, char* output, size_t outputLength)
+{
+  uLongf destLen = static_cast<uLongf>(outputLength);
+  int result = uncompress(reinterpret_cast<Bytef*>(output), &destLen,
+    reinterpret_cast<const Bytef*>(input), static_cast<uLong>(length));
+  return result == Z_OK && destLen == static_cast<uLongf>(outputLength);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVZLibDataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
+}
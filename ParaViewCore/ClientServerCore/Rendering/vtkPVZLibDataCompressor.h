@@ -0,0 +1,64 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVZLibDataCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVZLibDataCompressor
+ * @brief   vtkPVDataCompressor using zlib.
+ *
+ * vtkPVZLibDataCompressor trades speed for compression ratio. It is well
+ * suited to low bandwidth connections such as remote client sessions.
+*/
+
+#ifndef vtkPVZLibDataCompressor_h
+#define vtkPVZLibDataCompressor_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+#include "vtkPVDataCompressor.h"
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVZLibDataCompressor : public vtkPVDataCompressor
+{
+public:
+  static vtkPVZLibDataCompressor* New();
+  vtkTypeMacro(vtkPVZLibDataCompressor, vtkPVDataCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * zlib compression level between 1 (fastest) and 9 (best ratio).
+   * Default is 6.
+   */
+  vtkSetClampMacro(CompressionLevel, int, 1, 9);
+  vtkGetMacro(CompressionLevel, int);
+  //@}
+
+  const char* GetTag() VTK_OVERRIDE { return "pvzl"; }
+
+protected:
+  vtkPVZLibDataCompressor();
+  ~vtkPVZLibDataCompressor() override;
+
+  size_t GetCompressBound(size_t length) VTK_OVERRIDE;
+  size_t CompressChunk(
+    const char* input, size_t length, char* output, size_t capacity) VTK_OVERRIDE;
+  bool DecompressChunk(
+    const char* input, size_t length, char* output, size_t outputLength) VTK_OVERRIDE;
+
+  int CompressionLevel;
+
+private:
+  vtkPVZLibDataCompressor(const vtkPVZLibDataCompressor&) = delete;
+  void operator=(const vtkPVZLibDataCompressor&) = delete;
+};
+
+#endif
@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestInterpreterMethodCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that vtkClientServerInterpreter calls the command function that
+// handled a method last time directly, and that it falls back to the whole
+// superclass chain when that command function fails.
+
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerStream.h"
+#include "vtkNew.h"
+#include "vtkObject.h"
+#include "vtkObjectFactory.h"
+
+#include <cstring>
+#include <string>
+
+class vtkTestCacheBase : public vtkObject
+{
+public:
+  static vtkTestCacheBase* New();
+  vtkTypeMacro(vtkTestCacheBase, vtkObject);
+};
+vtkStandardNewMacro(vtkTestCacheBase);
+
+class vtkTestCacheDerived : public vtkTestCacheBase
+{
+public:
+  static vtkTestCacheDerived* New();
+  vtkTypeMacro(vtkTestCacheDerived, vtkTestCacheBase);
+};
+vtkStandardNewMacro(vtkTestCacheDerived);
+
+namespace
+{
+int BaseCalls = 0;
+int DerivedCalls = 0;
+
+// Handles Value(int) for non-negative values.
+int vtkTestCacheBaseCommand(vtkClientServerInterpreter*, vtkObjectBase*, const char* method,
+  const vtkClientServerStream& msg, vtkClientServerStream& result, void*)
+{
+  ++BaseCalls;
+  int value;
+  if (!strcmp(method, "Value") && msg.GetNumberOfArguments(0) == 3 &&
+    msg.GetArgument(0, 2, &value) && value >= 0)
+  {
+    result.Reset();
+    result << vtkClientServerStream::Reply << "base" << vtkClientServerStream::End;
+    return 1;
+  }
+  result.Reset();
+  result << vtkClientServerStream::Error << "Unsupported method " << method
+         << vtkClientServerStream::End;
+  return 0;
+}
+
+// Handles Value(int) for negative values, and forwards everything else to
+// the superclass, as generated command functions do.
+int vtkTestCacheDerivedCommand(vtkClientServerInterpreter* interp, vtkObjectBase* ob,
+  const char* method, const vtkClientServerStream& msg, vtkClientServerStream& result, void*)
+{
+  ++DerivedCalls;
+  int value;
+  if (!strcmp(method, "Value") && msg.GetNumberOfArguments(0) == 3 &&
+    msg.GetArgument(0, 2, &value) && value < 0)
+  {
+    result.Reset();
+    result << vtkClientServerStream::Reply << "derived" << vtkClientServerStream::End;
+    return 1;
+  }
+  return interp->CallCommandFunction("vtkTestCacheBase", ob, method, msg, result);
+}
+
+bool Invoke(vtkClientServerInterpreter* interp, vtkObjectBase* obj, int value,
+  const char* expectedHandler, int expectedBaseCalls, int expectedDerivedCalls)
+{
+  BaseCalls = DerivedCalls = 0;
+  vtkClientServerStream stream;
+  stream << vtkClientServerStream::Invoke << obj << "Value" << value
+         << vtkClientServerStream::End;
+  const char* handler = NULL;
+  if (!interp->ProcessStream(stream) || !interp->GetLastResult().GetArgument(0, 0, &handler) ||
+    std::string(handler) != expectedHandler)
+  {
+    cerr << "Value(" << value << ") was not handled by " << expectedHandler << endl;
+    return false;
+  }
+  if (BaseCalls != expectedBaseCalls || DerivedCalls != expectedDerivedCalls)
+  {
+    cerr << "Value(" << value << ") called the base and derived command functions " << BaseCalls
+         << " and " << DerivedCalls << " times instead of " << expectedBaseCalls << " and "
+         << expectedDerivedCalls << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestInterpreterMethodCache(int, char* [])
+{
+  vtkNew<vtkClientServerInterpreter> interp;
+  interp->AddCommandFunction("vtkTestCacheBase", vtkTestCacheBaseCommand);
+  interp->AddCommandFunction("vtkTestCacheDerived", vtkTestCacheDerivedCommand);
+  vtkNew<vtkTestCacheDerived> obj;
+
+  // The first call goes through the derived command function, the next one
+  // calls the base command function directly.
+  if (!Invoke(interp.GetPointer(), obj.GetPointer(), 1, "base", 1, 1) ||
+    !Invoke(interp.GetPointer(), obj.GetPointer(), 2, "base", 1, 0))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // A different argument type has an entry of its own, so the chain runs
+  // from the derived command function.
+  BaseCalls = DerivedCalls = 0;
+  vtkClientServerStream stream;
+  stream << vtkClientServerStream::Invoke << obj.GetPointer() << "Value" << 4.5
+         << vtkClientServerStream::End;
+  interp->ProcessStream(stream);
+  if (DerivedCalls != 1)
+  {
+    cerr << "Value(double) should not have used the entry of Value(int)." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The cached base command function fails for a negative value, so the
+  // whole chain runs and the derived command function is cached instead.
+  if (!Invoke(interp.GetPointer(), obj.GetPointer(), -1, "derived", 1, 1) ||
+    !Invoke(interp.GetPointer(), obj.GetPointer(), -2, "derived", 0, 1) ||
+    !Invoke(interp.GetPointer(), obj.GetPointer(), 3, "base", 1, 1))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
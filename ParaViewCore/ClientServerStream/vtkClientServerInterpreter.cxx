@@ -21,6 +21,7 @@
 
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 #include <string>
@@ -75,8 +76,138 @@ public:
   NewInstanceFunctionsType NewInstanceFunctions;
   ClassToFunctionMapType ClassToFunctionMap;
   IDToMessageMapType IDToMessageMap;
+
+  // A command function (of the class of the target object or one of its
+  // superclasses) that handled a method the last time it was invoked with
+  // the same argument types, and the class of object arguments. Since the
+  // generated wrappers pick an overload based on these only, the same command
+  // function will handle the message again and the superclass chain can be
+  // skipped. Array and string lengths are not part of the key.
+  struct MethodCacheEntry
+  {
+    const CommandFunction* Handler;
+    std::string ClassName;
+    std::string Method;
+    std::vector<int> ArgumentTypes;
+    std::vector<std::string> ArgumentClasses;
+
+    MethodCacheEntry()
+      : Handler(NULL)
+    {
+    }
+
+    static const char* GetArgumentClass(const vtkClientServerStream& msg, int i)
+    {
+      vtkObjectBase* arg = NULL;
+      msg.GetArgument(0, i, &arg);
+      return arg ? arg->GetClassName() : "";
+    }
+
+    bool Matches(vtkObjectBase* obj, const char* method, const vtkClientServerStream& msg) const
+    {
+      const int numArgs = msg.GetNumberOfArguments(0) - 2;
+      if (!this->Handler || this->ArgumentTypes.size() != static_cast<size_t>(numArgs) ||
+        this->ClassName != obj->GetClassName() || this->Method != method)
+      {
+        return false;
+      }
+      size_t object = 0;
+      for (int i = 0; i < numArgs; ++i)
+      {
+        vtkClientServerStream::Types type = msg.GetArgumentType(0, i + 2);
+        if (this->ArgumentTypes[i] != static_cast<int>(type))
+        {
+          return false;
+        }
+        if (type == vtkClientServerStream::vtk_object_pointer &&
+          this->ArgumentClasses[object++] != GetArgumentClass(msg, i + 2))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    void Set(const CommandFunction* handler, vtkObjectBase* obj, const char* method,
+      const vtkClientServerStream& msg)
+    {
+      this->Handler = handler;
+      this->ClassName = obj->GetClassName();
+      this->Method = method;
+      this->ArgumentTypes.clear();
+      this->ArgumentClasses.clear();
+      for (int i = 2, max = msg.GetNumberOfArguments(0); i < max; ++i)
+      {
+        vtkClientServerStream::Types type = msg.GetArgumentType(0, i);
+        this->ArgumentTypes.push_back(static_cast<int>(type));
+        if (type == vtkClientServerStream::vtk_object_pointer)
+        {
+          this->ArgumentClasses.push_back(GetArgumentClass(msg, i));
+        }
+      }
+    }
+  };
+
+  // The cache is a fixed size table indexed by a hash of the class, method
+  // and argument types, so that it does not grow with the number of distinct
+  // messages. A new entry replaces the one at the same index.
+  enum
+  {
+    MethodCacheSize = 1024
+  };
+  MethodCacheEntry MethodCache[MethodCacheSize];
+
+  // The command function that handled the current invoke message. Set by
+  // the innermost successful CallCommandFunction.
+  const CommandFunction* LastHandler;
+
+  vtkClientServerInterpreterInternals()
+    : LastHandler(NULL)
+  {
+  }
+
+  MethodCacheEntry& GetMethodCacheEntry(
+    vtkObjectBase* obj, const char* method, const vtkClientServerStream& msg)
+  {
+    // FNV-1a hash.
+    vtkTypeUInt32 hash = 2166136261u;
+    for (const char* c = obj->GetClassName(); *c; ++c)
+    {
+      hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+    }
+    for (const char* c = method; *c; ++c)
+    {
+      hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+    }
+    for (int i = 2, max = msg.GetNumberOfArguments(0); i < max; ++i)
+    {
+      hash = (hash ^ static_cast<vtkTypeUInt32>(msg.GetArgumentType(0, i))) * 16777619u;
+    }
+    return this->MethodCache[hash % MethodCacheSize];
+  }
+
+  void ClearMethodCache()
+  {
+    for (int i = 0; i < MethodCacheSize; ++i)
+    {
+      this->MethodCache[i].Handler = NULL;
+    }
+  }
 };
 
+namespace
+{
+struct vtkClientServerMethodEntryLess
+{
+  bool operator()(const vtkClientServerMethodEntry& entry,
+    const std::pair<const char*, int>& method) const
+  {
+    int cmp = strcmp(entry.Name, method.first);
+    return cmp < 0 || (cmp == 0 && entry.NumberOfArguments < method.second);
+  }
+};
+}
+
 //----------------------------------------------------------------------------
 vtkClientServerInterpreter::vtkClientServerInterpreter()
 {
@@ -420,8 +551,37 @@ int vtkClientServerInterpreter::ProcessCommandInvoke(const vtkClientServerStream
     // Find the command function for this object's type.
     if (obj && this->HasCommandFunction(obj->GetClassName()))
     {
-      if (this->CallCommandFunction(
-            obj->GetClassName(), obj, method, msg, *this->LastResultMessage))
+      // Try the command function that handled the same method and argument
+      // types last time, if any.
+      vtkClientServerInterpreterInternals::MethodCacheEntry& cached =
+        this->Internal->GetMethodCacheEntry(obj, method, msg);
+      if (cached.Matches(obj, method, msg))
+      {
+        const vtkClientServerInterpreterInternals::CommandFunction* n = cached.Handler;
+        void* ctx = n->Context ? n->Context->Context : 0;
+        if (n->Function(this, obj, method, msg, *this->LastResultMessage, ctx))
+        {
+          return 1;
+        }
+        this->LastResultMessage->Reset();
+      }
+
+      // Methods invoked below may process nested messages, save the handler
+      // of the enclosing message.
+      const vtkClientServerInterpreterInternals::CommandFunction* enclosingHandler =
+        this->Internal->LastHandler;
+      this->Internal->LastHandler = NULL;
+      int result = this->CallCommandFunction(
+        obj->GetClassName(), obj, method, msg, *this->LastResultMessage);
+      if (result && this->Internal->LastHandler)
+      {
+        // The entry is looked up again since nested messages may have
+        // replaced it.
+        this->Internal->GetMethodCacheEntry(obj, method, msg)
+          .Set(this->Internal->LastHandler, obj, method, msg);
+      }
+      this->Internal->LastHandler = enclosingHandler;
+      if (result)
       {
         return 1;
       }
@@ -765,6 +925,9 @@ void vtkClientServerInterpreter::AddCommandFunction(const char* cname,
     return;
   }
 
+  // A new wrapper may change how the superclass chains resolve methods.
+  this->Internal->ClearMethodCache();
+
   vtkClientServerInterpreterInternals::ContextInformation* context = NULL;
   if (ctx || freeFunction)
   {
@@ -802,7 +965,29 @@ int vtkClientServerInterpreter::CallCommandFunction(const char* cname, vtkObject
 
   vtkClientServerCommandFunction function = n->Function;
   void* ctx = n->Context ? n->Context->Context : 0;
-  return function(this, ptr, method, msg, result, ctx);
+  int status = function(this, ptr, method, msg, result, ctx);
+  if (status && !this->Internal->LastHandler)
+  {
+    // Superclass command functions are called from within the subclass
+    // ones, so the first to return is the one that handled the method.
+    this->Internal->LastHandler = n;
+  }
+  return status;
+}
+
+//----------------------------------------------------------------------------
+const vtkClientServerMethodEntry* vtkClientServerInterpreter::FindMethod(
+  const vtkClientServerMethodEntry* begin, const vtkClientServerMethodEntry* end,
+  const char* method, int numberOfArguments)
+{
+  const vtkClientServerMethodEntry* entry = std::lower_bound(
+    begin, end, std::make_pair(method, numberOfArguments), vtkClientServerMethodEntryLess());
+  if (entry != end &&
+    (entry->NumberOfArguments != numberOfArguments || strcmp(entry->Name, method) != 0))
+  {
+    return end;
+  }
+  return entry;
 }
 
 void vtkClientServerInterpreter::AddNewInstanceFunction(const char* name,
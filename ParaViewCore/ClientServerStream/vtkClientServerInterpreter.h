@@ -48,6 +48,19 @@ typedef vtkObjectBase* (*vtkClientServerNewInstanceFunction)(void* ctx);
 
 typedef void (*vtkContextFreeFunction)(void* ctx);
 
+/**
+ * An entry of the method table generated for each wrapped class.  The
+ * entries are sorted by method name and number of message arguments,
+ * overloads with the same key keep their declaration order.  Index selects
+ * the code that tries the overload.
+ */
+struct vtkClientServerMethodEntry
+{
+  const char* Name;
+  int NumberOfArguments;
+  int Index;
+};
+
 /**
  * A pointer to this struct is sent as call data when an ErrorEvent is
  * invoked by the interpreter.
@@ -150,6 +163,14 @@ public:
   int CallCommandFunction(const char* classname, vtkObjectBase* ptr, const char* method,
     const vtkClientServerStream& msg, vtkClientServerStream& result);
 
+  /**
+   * Called by generated code to look up a method in its sorted method
+   * table.  Returns the first entry matching the method name and number of
+   * arguments, or end if there is none.
+   */
+  static const vtkClientServerMethodEntry* FindMethod(const vtkClientServerMethodEntry* begin,
+    const vtkClientServerMethodEntry* end, const char* method, int numberOfArguments);
+
   /**
    * Add a function used to create new objects.
    */
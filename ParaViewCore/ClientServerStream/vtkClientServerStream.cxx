@@ -18,6 +18,7 @@
 #include "vtkArrayIterator.h"
 #include "vtkArrayIteratorIncludes.h"
 #include "vtkByteSwap.h"
+#include "vtkMutexLock.h"
 #include "vtkSmartPointer.h"
 #include "vtkType.h"
 #include "vtkTypeTraits.h"
@@ -251,11 +252,93 @@ const vtkClientServerStreamInternals::ValueOffsetsType::size_type
   vtkClientServerStreamInternals::InvalidStartIndex =
     static_cast<vtkClientServerStreamInternals::ValueOffsetsType::size_type>(-1);
 
+//----------------------------------------------------------------------------
+// A stream is created for nearly every message exchanged between the client
+// and the servers. To avoid allocating the buffers for each of them, the
+// internal representations of destroyed streams are kept in a small pool and
+// handed out to new streams. Buffers larger than MaximumCapacity are released
+// instead of being kept around.
+namespace
+{
+class vtkClientServerStreamInternalsPool
+{
+public:
+  enum
+  {
+    MaximumSize = 32,
+    MaximumCapacity = 64 * 1024
+  };
+
+  vtkClientServerStreamInternalsPool() { vtkClientServerStreamInternalsPool::Destroyed = false; }
+  ~vtkClientServerStreamInternalsPool()
+  {
+    for (size_t cc = 0; cc < this->Items.size(); ++cc)
+    {
+      delete this->Items[cc];
+    }
+    vtkClientServerStreamInternalsPool::Destroyed = true;
+  }
+
+  static vtkClientServerStreamInternalsPool* GetInstance()
+  {
+    static vtkClientServerStreamInternalsPool Instance;
+    return vtkClientServerStreamInternalsPool::Destroyed ? NULL : &Instance;
+  }
+
+  vtkClientServerStreamInternals* Pop(vtkObjectBase* owner)
+  {
+    vtkClientServerStreamInternals* internals = NULL;
+    this->Lock.Lock();
+    if (!this->Items.empty())
+    {
+      internals = this->Items.back();
+      this->Items.pop_back();
+    }
+    this->Lock.Unlock();
+    if (internals)
+    {
+      internals->Objects.Owner = owner;
+      return internals;
+    }
+    return new vtkClientServerStreamInternals(owner);
+  }
+
+  void Push(vtkClientServerStreamInternals* internals)
+  {
+    // Release the references held by the stream now, objects must not be kept
+    // alive by the pool.
+    internals->Objects.Clear();
+    internals->Objects.Owner = NULL;
+    if (internals->Data.capacity() <= static_cast<size_t>(MaximumCapacity))
+    {
+      this->Lock.Lock();
+      if (this->Items.size() < MaximumSize)
+      {
+        this->Items.push_back(internals);
+        internals = NULL;
+      }
+      this->Lock.Unlock();
+    }
+    delete internals;
+  }
+
+private:
+  vtkSimpleMutexLock Lock;
+  std::vector<vtkClientServerStreamInternals*> Items;
+
+  // Streams with static storage may be destroyed after the pool.
+  static bool Destroyed;
+};
+
+bool vtkClientServerStreamInternalsPool::Destroyed = false;
+}
+
 //----------------------------------------------------------------------------
 vtkClientServerStream::vtkClientServerStream(vtkObjectBase* owner)
 {
   // Initialize the internal representation of the stream.
-  this->Internal = new vtkClientServerStreamInternals(owner);
+  vtkClientServerStreamInternalsPool* pool = vtkClientServerStreamInternalsPool::GetInstance();
+  this->Internal = pool ? pool->Pop(owner) : new vtkClientServerStreamInternals(owner);
   this->Reserve(1024);
   this->Reset();
 }
@@ -263,7 +346,15 @@ vtkClientServerStream::vtkClientServerStream(vtkObjectBase* owner)
 //----------------------------------------------------------------------------
 vtkClientServerStream::~vtkClientServerStream()
 {
-  delete this->Internal;
+  vtkClientServerStreamInternalsPool* pool = vtkClientServerStreamInternalsPool::GetInstance();
+  if (pool)
+  {
+    pool->Push(this->Internal);
+  }
+  else
+  {
+    delete this->Internal;
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -300,9 +391,10 @@ vtkClientServerStream& vtkClientServerStream::Write(const void* data, size_t len
     return *this;
   }
 
-  // Copy the value into the data.
-  this->Internal->Data.resize(this->Internal->Data.size() + length);
-  memcpy(&*(this->Internal->Data.end() - length), data, length);
+  // Append the value to the data. The vector grows geometrically, so
+  // appending many small values does not reallocate each time.
+  const unsigned char* begin = static_cast<const unsigned char*>(data);
+  this->Internal->Data.insert(this->Internal->Data.end(), begin, begin + length);
   return *this;
 }
 
@@ -315,8 +407,17 @@ void vtkClientServerStream::Reserve(size_t size)
 //----------------------------------------------------------------------------
 void vtkClientServerStream::Reset()
 {
-  // Empty the entire stream.
-  vtkClientServerStreamInternals::DataType().swap(this->Internal->Data);
+  // Empty the entire stream. Keep the allocated memory for the next messages
+  // unless the stream has grown large.
+  if (this->Internal->Data.capacity() >
+    static_cast<size_t>(vtkClientServerStreamInternalsPool::MaximumCapacity))
+  {
+    vtkClientServerStreamInternals::DataType().swap(this->Internal->Data);
+  }
+  else
+  {
+    this->Internal->Data.clear();
+  }
 
   this->Internal->ValueOffsets.erase(
     this->Internal->ValueOffsets.begin(), this->Internal->ValueOffsets.end());
@@ -41,6 +41,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #define LOG(x)                                                                                     \
   if (this->LogStream)                                                                             \
@@ -885,21 +886,8 @@ void vtkPVSessionCore::GatherInformationStatelliteCallback()
 }
 
 //----------------------------------------------------------------------------
-#define SafeDeleteArray(array_ptr)                                                                 \
-  {                                                                                                \
-    if (array_ptr != NULL)                                                                         \
-    {                                                                                              \
-      delete[] array_ptr;                                                                          \
-      array_ptr = NULL;                                                                            \
-    }                                                                                              \
-  }
-
 bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
 {
-  // Sanity checks
-  assert("pre: NULL PV information!" && (info != NULL));
-
-  // STEP 0: temporary variables
   int rank = this->ParallelController->GetLocalProcessId();
   int nranks = this->ParallelController->GetNumberOfProcesses();
 
@@ -909,81 +897,63 @@ bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
     return true;
   }
 
-  vtkIdType* rcvcounts = NULL;     /* significant only at rank 0 */
-  vtkIdType* offSet = NULL;        /* significant only at rank 0 */
-  int rbufsize = 0;                /* significant only at rank 0 */
-  unsigned char* rcvbuffer = NULL; /* significant only at rank 0 */
-
-  // STEP 1: Initialize data-structures at rank 0
-  if (rank == 0)
+  // Reduce the information objects along a binary tree rooted at rank 0. In
+  // the round with the given step, every rank that is an odd multiple of step
+  // sends its (partially reduced) information to rank - step and is done,
+  // while the others receive and add the information from rank + step. This
+  // takes log2(nranks) rounds instead of having rank 0 receive and add the
+  // information from every other rank in turn. Information is still added in
+  // increasing rank order.
+  std::vector<unsigned char> rcvbuffer;
+  for (int step = 1; step < nranks; step *= 2)
   {
-    rcvcounts = new vtkIdType[nranks];
-    offSet = new vtkIdType[nranks];
-  } // END if rank == 0
-
-  // STEP 2: Serialize the vtkPVInformation object
-  vtkClientServerStream stream;
-  info->CopyToStream(&stream);
-
-  const unsigned char* data;
-  size_t length;
-
-  // Get pointer to the raw stream data. Note, this is a shallow copy, no
-  // need to delete the data.
-  stream.GetData(&data, &length);
-  vtkIdType local_length = static_cast<vtkIdType>(length);
-
-  // STEP 3: Get number of bytes that each process will send
-  this->ParallelController->Gather(&local_length, rcvcounts, 1, 0);
-
-  // STEP 4: Allocate temporary arrays at rank 0
-  if (rank == 0)
-  {
-    // STEP 4.1: Calculate rcvbuffer size & allocate rcvbuffer
-    rbufsize = rcvcounts[0];
-    for (int i = 1; i < nranks; ++i)
+    if (rank % (2 * step) != 0)
     {
-      rbufsize += rcvcounts[i];
+      // A NULL info (the satellite failed to create the information object)
+      // is sent as an empty message so that the parent does not hang.
+      vtkClientServerStream stream;
+      const unsigned char* data = NULL;
+      size_t length = 0;
+      if (info)
+      {
+        info->CopyToStream(&stream);
+
+        // Get pointer to the raw stream data. Note, this is a shallow copy, no
+        // need to delete the data.
+        stream.GetData(&data, &length);
+      }
+      vtkIdType local_length = static_cast<vtkIdType>(length);
+      this->ParallelController->Send(&local_length, 1, rank - step, ROOT_SATELLITE_INFO_TAG);
+      if (local_length > 0)
+      {
+        this->ParallelController->Send(data, local_length, rank - step, ROOT_SATELLITE_INFO_TAG);
+      }
+      break;
     }
-    rcvbuffer = new unsigned char[rbufsize];
 
-    // STEP 4.2: populate offset array
-    offSet[0] = 0;
-    for (int i = 1; i < nranks; ++i)
+    const int child = rank + step;
+    if (child < nranks)
     {
-      offSet[i] = offSet[i - 1] + rcvcounts[i - 1];
+      vtkIdType rcvlength = 0;
+      this->ParallelController->Receive(&rcvlength, 1, child, ROOT_SATELLITE_INFO_TAG);
+      if (rcvlength > 0)
+      {
+        rcvbuffer.resize(static_cast<size_t>(rcvlength));
+        this->ParallelController->Receive(&rcvbuffer[0], rcvlength, child, ROOT_SATELLITE_INFO_TAG);
+        if (info)
+        {
+          vtkClientServerStream rcvStream;
+          rcvStream.SetData(&rcvbuffer[0], rcvbuffer.size());
+          vtkPVInformation* tempInfo = info->NewInstance();
+          tempInfo->CopyFromStream(&rcvStream);
+          info->AddInformation(tempInfo);
+          tempInfo->Delete();
+        }
+      }
     }
-  } // END if rank==0
-
-  // STEP 5: GatherV all data from satellites
-  this->ParallelController->GatherV(data, rcvbuffer, local_length, rcvcounts, offSet, 0);
+  }
 
-  // STEP 6: Deserialize data from other ranks at rank 0 and add them to
-  // the information object associated with rank 0.
-  if (rank == 0)
-  {
-    vtkClientServerStream rcvStream;
-    for (int i = 1; i < nranks; ++i)
-    {
-      rcvStream.SetData(&rcvbuffer[offSet[i]], rcvcounts[i]);
-      vtkPVInformation* tempInfo = info->NewInstance();
-      tempInfo->CopyFromStream(&rcvStream);
-      info->AddInformation(tempInfo);
-      tempInfo->Delete();
-    } // END for all remote ranks
-  }   // END if rank == 0
-
-  // STEP 7: De-allocate temporary arrays at rank 0
-  SafeDeleteArray(rcvcounts);
-  SafeDeleteArray(offSet);
-  SafeDeleteArray(rcvbuffer);
-
-  // Sanity checks -- ensure we return all dynamically allocated memory
-  assert("post: rcvcounts should be NULL" && (rcvcounts == NULL));
-  assert("post: offSet should be NULL" && (offSet == NULL));
-  assert("post: rcvbuffer should be NULL" && (rcvbuffer == NULL));
-
-  // STEP 8: Barrier synchronization
+  // Barrier synchronization
   this->ParallelController->Barrier();
   return true;
 }
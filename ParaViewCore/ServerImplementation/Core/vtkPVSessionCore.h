@@ -211,7 +211,9 @@ protected:
   bool GatherInformationInternal(vtkPVInformation* information, vtkTypeUInt32 globalid);
 
   /**
-   * Gather informations across MPI satellites.
+   * Gather informations across MPI satellites. The information objects are
+   * reduced along a binary tree, so only rank 0 ends up with the information
+   * from all ranks.
    */
   bool CollectInformation(vtkPVInformation*);
 
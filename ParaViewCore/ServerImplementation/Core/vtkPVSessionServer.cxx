@@ -534,25 +534,35 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
   switch (type)
   {
     case vtkPVSessionServer::PUSH:
+    case vtkPVSessionServer::PUSH_BATCH:
     {
-      std::string string;
-      stream >> string;
-      vtkSMMessage msg;
-      msg.ParseFromString(string);
-
-      //      cout << "=================================" << endl;
-      //      msg.PrintDebugString();
-      //      cout << "=================================" << endl;
-
-      // Do we skip the processing ?
-      if (!this->Internal->StoreShareOnly(&msg))
+      // A batch is a sequence of pushes sent in a single message.
+      int count = 1;
+      if (type == vtkPVSessionServer::PUSH_BATCH)
       {
-        this->PushState(&msg);
+        stream >> count;
+      }
+      for (int cc = 0; cc < count; cc++)
+      {
+        std::string string;
+        stream >> string;
+        vtkSMMessage msg;
+        msg.ParseFromString(string);
+
+        //      cout << "=================================" << endl;
+        //      msg.PrintDebugString();
+        //      cout << "=================================" << endl;
+
+        // Do we skip the processing ?
+        if (!this->Internal->StoreShareOnly(&msg))
+        {
+          this->PushState(&msg);
+        }
+
+        // Notify when ProxyManager state has changed
+        // or any other state change
+        this->NotifyOtherClients(&msg);
       }
-
-      // Notify when ProxyManager state has changed
-      // or any other state change
-      this->NotifyOtherClients(&msg);
     }
     break;
 
@@ -17,6 +17,7 @@
 #include "vtkAlgorithm.h"
 #include "vtkClientServerInterpreter.h"
 #include "vtkClientServerStream.h"
+#include "vtkFileSeriesReader.h"
 #include "vtkInformation.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
@@ -62,6 +63,13 @@ void vtkSIMetaReaderProxy::OnCreateVTKObjects()
            << this->GetFileNameMethod() << vtkClientServerStream::End;
   }
   this->Interpreter->ProcessStream(stream);
+
+  // Let file series readers distribute the time information collection among
+  // the processes.
+  if (vtkFileSeriesReader* seriesReader = vtkFileSeriesReader::SafeDownCast(this->GetVTKObject()))
+  {
+    seriesReader->SetController(vtkMultiProcessController::GetGlobalController());
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -43,6 +43,8 @@
 #include <vtksys/RegularExpression.hxx>
 
 #include <assert.h>
+#include <ctype.h>
+#include <string.h>
 
 // this file must be included after vtkPVConfig etc. are included.
 // #include "vtkSMGeneratedModules.h"
@@ -51,7 +53,90 @@
 //                    Internal Classes and typedefs
 //****************************************************************************/
 typedef vtkSmartPointer<vtkPVXMLElement> XMLElement;
-typedef std::map<vtkStdString, XMLElement> StrToXmlMap;
+
+//****************************************************************************/
+// A registered proxy definition. Definitions loaded from server manager
+// configuration strings are only indexed at load time and keep the XML text
+// of the proxy element; the element (and any extension registered for it) is
+// parsed the first time it is requested. This avoids building the element
+// tree of every proxy on every process at startup.
+class XMLDefinition
+{
+public:
+  XMLDefinition() {}
+  XMLDefinition(vtkPVXMLElement* element)
+    : Element(element)
+  {
+  }
+
+  //-------------------------------------------------------------------------
+  vtkPVXMLElement* GetPointer() const
+  {
+    if (!this->Element && !this->XML.empty())
+    {
+      this->Element = vtkPVXMLParser::ParseXML(this->XML.c_str());
+      std::string().swap(this->XML);
+      for (size_t cc = 0; this->Element && cc < this->Extensions.size(); ++cc)
+      {
+        this->Extend(this->Extensions[cc]);
+      }
+      std::vector<std::string>().swap(this->Extensions);
+    }
+    return this->Element.GetPointer();
+  }
+
+  //-------------------------------------------------------------------------
+  void SetXML(const std::string& xml)
+  {
+    this->Element = NULL;
+    this->XML = xml;
+    this->Extensions.clear();
+  }
+
+  //-------------------------------------------------------------------------
+  void AddExtensionXML(const std::string& xml)
+  {
+    if (this->Element)
+    {
+      this->Extend(xml);
+    }
+    else
+    {
+      this->Extensions.push_back(xml);
+    }
+  }
+
+  //-------------------------------------------------------------------------
+  // Writes the definition as XML, without parsing it if it was not needed
+  // yet.
+  void PrintXML(ostream& os) const
+  {
+    if (!this->Element && this->Extensions.empty())
+    {
+      os << this->XML;
+    }
+    else if (vtkPVXMLElement* element = this->GetPointer())
+    {
+      element->PrintXML(os, vtkIndent());
+    }
+  }
+
+private:
+  void Extend(const std::string& xml) const
+  {
+    vtkSmartPointer<vtkPVXMLElement> extension = vtkPVXMLParser::ParseXML(xml.c_str());
+    for (unsigned int cc = 0; extension && cc < extension->GetNumberOfNestedElements(); cc++)
+    {
+      this->Element->AddNestedElement(extension->GetNestedElement(cc));
+    }
+  }
+
+  mutable XMLElement Element;
+  mutable std::string XML;
+  mutable std::vector<std::string> Extensions;
+};
+
+typedef std::map<vtkStdString, XMLDefinition> StrToXmlMap;
 typedef std::map<vtkStdString, StrToXmlMap> StrToStrToXmlMap;
 
 class vtkSIProxyDefinitionManager::vtkInternals
@@ -138,6 +223,200 @@ public:
     return elementToReturn;
   }
 
+  //-------------------------------------------------------------------------
+  struct ProxyDefinitionText
+  {
+    std::string GroupName;
+    std::string ProxyName;
+    bool IsExtension;
+    std::string XML;
+  };
+
+  //-------------------------------------------------------------------------
+  // Split a ServerManagerConfiguration document into the XML text of its
+  // proxy elements, without building the element tree. Returns false when
+  // the document is not a plain ServerManagerConfiguration, is not well
+  // formed (e.g. mismatched end tags) or uses constructs this does not
+  // handle; the caller must then parse it, which also reports the errors.
+  static bool IndexConfigurationXML(
+    const char* xml, std::vector<ProxyDefinitionText>& definitions)
+  {
+    std::string groupName;
+    const char* proxyBegin = NULL;
+    std::vector<std::string> openTags;
+    int depth = 0;
+    bool seenRoot = false;
+    const char* pos = xml;
+    while ((pos = strchr(pos, '<')) != NULL)
+    {
+      const char* skipTo = NULL;
+      if (strncmp(pos, "<?", 2) == 0)
+      {
+        skipTo = "?>";
+      }
+      else if (strncmp(pos, "<!--", 4) == 0)
+      {
+        skipTo = "-->";
+      }
+      else if (strncmp(pos, "<![CDATA[", 9) == 0)
+      {
+        skipTo = "]]>";
+      }
+      else if (pos[1] == '!')
+      {
+        // DOCTYPE and the like.
+        return false;
+      }
+      if (skipTo)
+      {
+        pos = strstr(pos, skipTo);
+        if (!pos)
+        {
+          return false;
+        }
+        pos += strlen(skipTo);
+        continue;
+      }
+
+      if (pos[1] == '/')
+      {
+        // end tag: it must close the innermost open element.
+        const char* endNameBegin = pos + 2;
+        const char* endNameEnd = endNameBegin;
+        while (*endNameEnd && !isspace(static_cast<unsigned char>(*endNameEnd)) &&
+          *endNameEnd != '>')
+        {
+          ++endNameEnd;
+        }
+        pos = endNameEnd;
+        while (*pos && isspace(static_cast<unsigned char>(*pos)))
+        {
+          ++pos;
+        }
+        if (*pos != '>' || depth == 0 ||
+          openTags.back().compare(0, std::string::npos, endNameBegin,
+            static_cast<size_t>(endNameEnd - endNameBegin)) != 0)
+        {
+          return false;
+        }
+        openTags.pop_back();
+        ++pos;
+        if (--depth == 2)
+        {
+          definitions.back().XML.assign(proxyBegin, pos);
+        }
+        continue;
+      }
+
+      // start tag: read the name and the "name" attribute.
+      const char* tagBegin = pos++;
+      const char* tagNameEnd = pos;
+      while (*tagNameEnd && !isspace(static_cast<unsigned char>(*tagNameEnd)) &&
+        *tagNameEnd != '/' && *tagNameEnd != '>')
+      {
+        ++tagNameEnd;
+      }
+      std::string tagName(pos, tagNameEnd);
+      std::string nameAttribute;
+      pos = tagNameEnd;
+      bool selfClosing = false;
+      for (;;)
+      {
+        while (*pos && isspace(static_cast<unsigned char>(*pos)))
+        {
+          ++pos;
+        }
+        if (*pos == '>')
+        {
+          break;
+        }
+        if (*pos == '/' && pos[1] == '>')
+        {
+          selfClosing = true;
+          ++pos;
+          break;
+        }
+        const char* attrBegin = pos;
+        while (*pos && *pos != '=' && *pos != '>' && !isspace(static_cast<unsigned char>(*pos)))
+        {
+          ++pos;
+        }
+        std::string attrName(attrBegin, pos);
+        while (*pos && isspace(static_cast<unsigned char>(*pos)))
+        {
+          ++pos;
+        }
+        if (*pos != '=')
+        {
+          return false;
+        }
+        ++pos;
+        while (*pos && isspace(static_cast<unsigned char>(*pos)))
+        {
+          ++pos;
+        }
+        const char quote = *pos;
+        if (quote != '"' && quote != '\'')
+        {
+          return false;
+        }
+        const char* valueEnd = strchr(pos + 1, quote);
+        if (!valueEnd)
+        {
+          return false;
+        }
+        if (attrName == "name")
+        {
+          nameAttribute.assign(pos + 1, valueEnd);
+          if (nameAttribute.find('&') != std::string::npos)
+          {
+            // would need entity decoding.
+            return false;
+          }
+        }
+        pos = valueEnd + 1;
+      }
+      if (*pos != '>')
+      {
+        return false;
+      }
+      ++pos;
+
+      if (depth == 0)
+      {
+        if (seenRoot || tagName != "ServerManagerConfiguration")
+        {
+          return false;
+        }
+        seenRoot = true;
+      }
+      else if (depth == 1)
+      {
+        groupName = nameAttribute;
+      }
+      else if (depth == 2)
+      {
+        ProxyDefinitionText definition;
+        definition.GroupName = groupName;
+        definition.ProxyName = nameAttribute;
+        definition.IsExtension = (tagName == "Extension");
+        if (selfClosing)
+        {
+          definition.XML.assign(tagBegin, pos);
+        }
+        proxyBegin = tagBegin;
+        definitions.push_back(definition);
+      }
+      if (!selfClosing)
+      {
+        openTags.push_back(tagName);
+        ++depth;
+      }
+    }
+    return seenRoot && depth == 0;
+  }
+
+  //-------------------------------------------------------------------------
   static void ExtractMetaInformation(vtkPVXMLElement* proxy,
     std::map<std::string, vtkSmartPointer<vtkPVXMLElement> >& subProxyMap,
     std::map<std::string, vtkSmartPointer<vtkPVXMLElement> >& propertyMap)
@@ -300,6 +579,21 @@ public:
   //-------------------------------------------------------------------------
   void GoToNextGroup() VTK_OVERRIDE { this->NextGroup(); }
 
+  //-------------------------------------------------------------------------
+  // Write the current definition as XML. Unlike GetProxyDefinition(), this
+  // does not need to parse definitions that were not used yet.
+  void PrintProxyDefinition(ostream& os)
+  {
+    if (this->IsCustom())
+    {
+      this->CustomProxyIterator->second.PrintXML(os);
+    }
+    else
+    {
+      this->CoreProxyIterator->second.PrintXML(os);
+    }
+  }
+
 protected:
   vtkInternalDefinitionIterator()
   {
@@ -511,6 +805,32 @@ void vtkSIProxyDefinitionManager::AddElement(
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::AddDeferredElement(
+  const char* groupName, const char* proxyName, bool isExtension, const std::string& xml)
+{
+  if (isExtension)
+  {
+    StrToStrToXmlMap::iterator group = this->Internals->CoreDefinitions.find(groupName);
+    StrToXmlMap::iterator proxy;
+    if (group == this->Internals->CoreDefinitions.end() ||
+      (proxy = group->second.find(proxyName)) == group->second.end())
+    {
+      vtkWarningMacro("Extension for (" << groupName << ", " << proxyName
+                                        << ") ignored since could not find core definition.");
+      return;
+    }
+    proxy->second.AddExtensionXML(xml);
+  }
+  else
+  {
+    this->Internals->CoreDefinitions[groupName][proxyName].SetXML(xml);
+  }
+
+  RegisteredDefinitionInformation info(groupName, proxyName, false);
+  this->InvokeEvent(vtkCommand::RegisterEvent, &info);
+}
+
 //---------------------------------------------------------------------------
 vtkPVXMLElement* vtkSIProxyDefinitionManager::GetProxyDefinition(
   const char* groupName, const char* proxyName, const bool throwError)
@@ -765,6 +1085,26 @@ bool vtkSIProxyDefinitionManager::LoadConfigurationXMLFromString(const char* xml
 bool vtkSIProxyDefinitionManager::LoadConfigurationXMLFromString(
   const char* xmlContent, bool attachHints)
 {
+  // Plain configurations are only indexed, proxy elements get parsed when
+  // first requested. Hints must be attached to the elements themselves, so
+  // those configurations are parsed right away.
+  std::vector<vtkInternals::ProxyDefinitionText> definitions;
+  if (!attachHints && xmlContent &&
+    vtkInternals::IndexConfigurationXML(xmlContent, definitions))
+  {
+    for (size_t cc = 0; cc < definitions.size(); ++cc)
+    {
+      const vtkInternals::ProxyDefinitionText& definition = definitions[cc];
+      if (!definition.ProxyName.empty())
+      {
+        this->AddDeferredElement(definition.GroupName.c_str(), definition.ProxyName.c_str(),
+          definition.IsExtension, definition.XML);
+      }
+    }
+    this->InvokeEvent(vtkSIProxyDefinitionManager::ProxyDefinitionsUpdated);
+    return true;
+  }
+
   vtkNew<vtkPVXMLParser> parser;
   return (parser->Parse(xmlContent) != 0) &&
     this->LoadConfigurationXML(parser->GetRootElement(), attachHints);
@@ -1069,15 +1409,16 @@ void vtkSIProxyDefinitionManager::Pull(vtkSMMessage* msg)
   // after. And for now, it is the less intrusive way to deal with server
   // XML definition centralisation state.
   ProxyDefinitionState_ProxyXMLDefinition* xmlDef;
-  vtkPVProxyDefinitionIterator* iter;
+  vtkInternalDefinitionIterator* iter;
 
   // Core Definition
-  iter = this->NewIterator(vtkSIProxyDefinitionManager::CORE_DEFINITIONS);
+  iter = vtkInternalDefinitionIterator::SafeDownCast(
+    this->NewIterator(vtkSIProxyDefinitionManager::CORE_DEFINITIONS));
   iter->GoToFirstItem();
   while (!iter->IsDoneWithTraversal())
   {
     std::ostringstream xmlContent;
-    iter->GetProxyDefinition()->PrintXML(xmlContent, vtkIndent());
+    iter->PrintProxyDefinition(xmlContent);
 
     xmlDef = msg->AddExtension(ProxyDefinitionState::xml_definition_proxy);
     xmlDef->set_group(iter->GetGroupName());
@@ -1089,7 +1430,8 @@ void vtkSIProxyDefinitionManager::Pull(vtkSMMessage* msg)
   iter->Delete();
 
   // Custome Definition
-  iter = this->NewIterator(vtkSIProxyDefinitionManager::CUSTOM_DEFINITIONS);
+  iter = vtkInternalDefinitionIterator::SafeDownCast(
+    this->NewIterator(vtkSIProxyDefinitionManager::CUSTOM_DEFINITIONS));
   iter->GoToFirstItem();
   while (!iter->IsDoneWithTraversal())
   {
@@ -1121,8 +1463,7 @@ void vtkSIProxyDefinitionManager::Push(vtkSMMessage* msg)
   for (int i = 0; i < size; i++)
   {
     xmlDef = &msg->GetExtension(ProxyDefinitionState::xml_definition_proxy, i);
-    parser->Parse(xmlDef->xml().c_str());
-    this->AddElement(xmlDef->group().c_str(), xmlDef->name().c_str(), parser->GetRootElement());
+    this->AddDeferredElement(xmlDef->group().c_str(), xmlDef->name().c_str(), false, xmlDef->xml());
   }
 
   // Manage custom ones
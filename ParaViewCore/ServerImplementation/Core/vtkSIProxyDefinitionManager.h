@@ -45,6 +45,8 @@
 #include "vtkPVServerImplementationCoreModule.h" //needed for exports
 #include "vtkSIObject.h"
 
+#include <string> // needed for std::string
+
 class vtkPVPlugin;
 class vtkPVProxyDefinitionIterator;
 class vtkPVXMLElement;
@@ -284,6 +286,14 @@ protected:
    */
   void AddElement(const char* groupName, const char* proxyName, vtkPVXMLElement* element);
 
+  /**
+   * Same as AddElement() but for the XML text of the element, which is only
+   * parsed when the definition is first requested. isExtension indicates an
+   * Extension element for an existing core definition.
+   */
+  void AddDeferredElement(
+    const char* groupName, const char* proxyName, bool isExtension, const std::string& xml);
+
   /**
    * Implementation for add custom proxy definition.
    */
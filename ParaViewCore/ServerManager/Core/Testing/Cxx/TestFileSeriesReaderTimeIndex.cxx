@@ -0,0 +1,330 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestFileSeriesReaderTimeIndex.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerInterpreterInitializer.h"
+#include "vtkClientServerStream.h"
+#include "vtkFileSeriesReader.h"
+#include "vtkImageAlgorithm.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkInitializationHelper.h"
+#include "vtkMultiProcessController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkProcessModule.h"
+#include "vtkSMParaViewPipelineController.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMProxy.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Reader of text files holding a single time value. The names of the files it
+// is asked to open are recorded to check which files the series reader scans.
+class vtkTestTimeValueReader : public vtkImageAlgorithm
+{
+public:
+  static vtkTestTimeValueReader* New();
+  vtkTypeMacro(vtkTestTimeValueReader, vtkImageAlgorithm);
+
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  static std::vector<std::string> OpenedFiles;
+
+protected:
+  vtkTestTimeValueReader() { this->FileName = NULL; }
+  ~vtkTestTimeValueReader() override { this->SetFileName(NULL); }
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector) VTK_OVERRIDE
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double time;
+    std::ifstream file(this->FileName ? this->FileName : "");
+    if (!(file >> time))
+    {
+      vtkErrorMacro("Cannot read " << (this->FileName ? this->FileName : "(null)"));
+      return 0;
+    }
+    OpenedFiles.push_back(this->FileName);
+
+    int extent[6] = { 0, 0, 0, 0, 0, 0 };
+    double range[2] = { time, time };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), &time, 1);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    return 1;
+  }
+
+  char* FileName;
+
+private:
+  vtkTestTimeValueReader(const vtkTestTimeValueReader&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkTestTimeValueReader&) VTK_DELETE_FUNCTION;
+};
+
+vtkStandardNewMacro(vtkTestTimeValueReader);
+std::vector<std::string> vtkTestTimeValueReader::OpenedFiles;
+
+namespace
+{
+const int NumberOfFiles = 4;
+
+// The series reader sets the file name of its reader through the interpreter,
+// which does not know about the test reader otherwise.
+int vtkTestTimeValueReaderCommand(vtkClientServerInterpreter*, vtkObjectBase* ob,
+  const char* method, const vtkClientServerStream& msg, vtkClientServerStream& resultStream, void*)
+{
+  vtkTestTimeValueReader* reader = vtkTestTimeValueReader::SafeDownCast(ob);
+  char* fname;
+  if (reader && !strcmp(method, "SetFileName") && msg.GetNumberOfArguments(0) == 3 &&
+    msg.GetArgument(0, 2, &fname))
+  {
+    reader->SetFileName(fname);
+    resultStream.Reset();
+    return 1;
+  }
+  resultStream.Reset();
+  resultStream << vtkClientServerStream::Error << "Unsupported method " << method
+               << vtkClientServerStream::End;
+  return 0;
+}
+
+bool WriteTimeValue(const std::string& fname, double time)
+{
+  std::ofstream file(fname.c_str());
+  file << time << endl;
+  return file.good();
+}
+
+bool ReadTimeSteps(
+  const std::vector<std::string>& fnames, const char* indexFileName, std::vector<double>& steps)
+{
+  vtkTestTimeValueReader::OpenedFiles.clear();
+
+  vtkNew<vtkTestTimeValueReader> timeReader;
+  vtkNew<vtkFileSeriesReader> reader;
+  reader->SetReader(timeReader.GetPointer());
+  reader->SetFileNameMethod("SetFileName");
+  reader->SetTimeIndexFileName(indexFileName);
+  for (size_t i = 0; i < fnames.size(); i++)
+  {
+    reader->AddFileName(fnames[i].c_str());
+  }
+  reader->UpdateInformation();
+
+  vtkInformation* outInfo = reader->GetOutputInformation(0);
+  steps.clear();
+  if (!outInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+  {
+    return false;
+  }
+  int numSteps = outInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  double* values = outInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  steps.assign(values, values + numSteps);
+  return true;
+}
+
+bool WasOpened(const std::string& fname)
+{
+  const std::vector<std::string>& opened = vtkTestTimeValueReader::OpenedFiles;
+  return std::find(opened.begin(), opened.end(), fname) != opened.end();
+}
+}
+
+int TestFileSeriesReaderTimeIndex(int argc, char* argv[])
+{
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  vtkNew<vtkSMParaViewPipelineController> controller;
+
+  // Create a new session.
+  vtkSMSession* session = vtkSMSession::New();
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+  if (!controller->InitializeSession(session))
+  {
+    cerr << "Failed to initialize ParaView session." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The reader proxy must hand the global controller to the file series reader
+  // and expose the time index file.
+  {
+    vtkSmartPointer<vtkSMProxy> readerProxy;
+    readerProxy.TakeReference(pxm->NewProxy("sources", "XMLImageDataReader"));
+    controller->PreInitializeProxy(readerProxy);
+    if (!readerProxy->GetProperty("TimeIndexFileName"))
+    {
+      cerr << "The reader proxy does not have a TimeIndexFileName property." << endl;
+      return EXIT_FAILURE;
+    }
+    vtkSMPropertyHelper(readerProxy, "TimeIndexFileName").Set("series.index");
+    readerProxy->UpdateVTKObjects();
+    vtkFileSeriesReader* seriesReader =
+      vtkFileSeriesReader::SafeDownCast(readerProxy->GetClientSideObject());
+    if (!seriesReader ||
+      seriesReader->GetController() != vtkMultiProcessController::GetGlobalController())
+    {
+      cerr << "The file series reader did not get the global controller." << endl;
+      return EXIT_FAILURE;
+    }
+    if (!seriesReader->GetTimeIndexFileName() ||
+      strcmp(seriesReader->GetTimeIndexFileName(), "series.index") != 0)
+    {
+      cerr << "The time index file name was not passed to the file series reader." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  vtkClientServerInterpreterInitializer::GetGlobalInterpreter()->AddCommandFunction(
+    "vtkTestTimeValueReader", vtkTestTimeValueReaderCommand);
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+  {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+  }
+  std::string prefix = tempDir;
+  prefix += "/TestFileSeriesReaderTimeIndex";
+  delete[] tempDir;
+
+  std::vector<std::string> fnames;
+  for (int i = 0; i < NumberOfFiles; i++)
+  {
+    std::ostringstream fname;
+    fname << prefix << "_" << i << ".txt";
+    fnames.push_back(fname.str());
+    if (!WriteTimeValue(fnames.back(), 0.5 * i))
+    {
+      cerr << "Failed to write " << fnames.back() << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  std::string indexFileName = prefix + ".index";
+  vtksys::SystemTools::RemoveFile(indexFileName);
+
+  // Files modified in the second the index is written are not taken from the
+  // index, so let the modification time of the files pass.
+  vtksys::SystemTools::Delay(1100);
+
+  std::vector<double> expected;
+  if (!ReadTimeSteps(fnames, NULL, expected) ||
+    expected.size() != static_cast<size_t>(NumberOfFiles))
+  {
+    cerr << "Unexpected time steps without an index file." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The first read scans every file and writes the index.
+  std::vector<double> steps;
+  if (!ReadTimeSteps(fnames, indexFileName.c_str(), steps) || steps != expected)
+  {
+    cerr << "Time steps differ when writing the index file." << endl;
+    return EXIT_FAILURE;
+  }
+  if (!vtksys::SystemTools::FileExists(indexFileName.c_str(), true) || !WasOpened(fnames[1]))
+  {
+    cerr << "The index file was not written." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The next read takes the time of the files after the first one from the
+  // index.
+  if (!ReadTimeSteps(fnames, indexFileName.c_str(), steps) || steps != expected)
+  {
+    cerr << "Time steps differ when reading the index file." << endl;
+    return EXIT_FAILURE;
+  }
+  if (WasOpened(fnames[1]) || WasOpened(fnames[2]))
+  {
+    cerr << "Files saved in the index were opened again." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // A file whose size changed is scanned again while the others still come
+  // from the index.
+  if (!WriteTimeValue(fnames[2], 1.0625))
+  {
+    cerr << "Failed to write " << fnames[2] << endl;
+    return EXIT_FAILURE;
+  }
+  if (!ReadTimeSteps(fnames, NULL, expected) ||
+    !ReadTimeSteps(fnames, indexFileName.c_str(), steps) || steps != expected)
+  {
+    cerr << "Time steps differ after a file of the series changed." << endl;
+    return EXIT_FAILURE;
+  }
+  if (WasOpened(fnames[1]) || !WasOpened(fnames[2]))
+  {
+    cerr << "Only the changed file should have been opened." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // A file the index does not know about is scanned as well.
+  std::string extraFileName = prefix + "_extra.txt";
+  if (!WriteTimeValue(extraFileName, 4.0))
+  {
+    cerr << "Failed to write " << extraFileName << endl;
+    return EXIT_FAILURE;
+  }
+  fnames.push_back(extraFileName);
+  if (!ReadTimeSteps(fnames, NULL, expected) ||
+    !ReadTimeSteps(fnames, indexFileName.c_str(), steps) || steps != expected)
+  {
+    cerr << "Time steps differ after a file was added to the series." << endl;
+    return EXIT_FAILURE;
+  }
+  if (WasOpened(fnames[1]) || !WasOpened(extraFileName))
+  {
+    cerr << "Only the added file should have been opened." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // A file rewritten with the same size right after the index was written has
+  // the same size and, most likely, the same modification time as in the
+  // index. It must be scanned again all the same.
+  for (int i = 0; i < 2; i++)
+  {
+    if (!WriteTimeValue(fnames[3], 2.5 + i) || !ReadTimeSteps(fnames, NULL, expected) ||
+      !ReadTimeSteps(fnames, indexFileName.c_str(), steps) || steps != expected)
+    {
+      cerr << "Time steps differ after a file was rewritten with the same size." << endl;
+      return EXIT_FAILURE;
+    }
+    if (!WasOpened(fnames[3]))
+    {
+      cerr << "The rewritten file should have been opened." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  session->Delete();
+  vtkInitializationHelper::Finalize();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestProxyDefinitionLazyLoading.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that proxy definitions parsed on first use, as done for the
+// configuration XMLs of ParaView, are identical to the definitions obtained
+// by parsing the whole configurations.
+
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkPVPlugin.h"
+#include "vtkPVPluginTracker.h"
+#include "vtkPVProxyDefinitionIterator.h"
+#include "vtkPVServerManagerPluginInterface.h"
+#include "vtkPVXMLElement.h"
+#include "vtkPVXMLParser.h"
+#include "vtkProcessModule.h"
+#include "vtkSIProxyDefinitionManager.h"
+#include "vtkSmartPointer.h"
+
+#include <sstream>
+#include <string>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+std::string PrintDefinition(vtkPVXMLElement* element)
+{
+  std::ostringstream stream;
+  if (element)
+  {
+    element->PrintXML(stream, vtkIndent());
+  }
+  return stream.str();
+}
+
+int CountDefinitions(vtkSIProxyDefinitionManager* manager)
+{
+  int count = 0;
+  vtkPVProxyDefinitionIterator* iter =
+    manager->NewIterator(vtkSIProxyDefinitionManager::CORE_DEFINITIONS);
+  for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    count++;
+  }
+  iter->Delete();
+  return count;
+}
+}
+
+int TestProxyDefinitionLazyLoading(int, char* argv[])
+{
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  std::vector<std::string> xmls;
+  vtkPVPluginTracker* tracker = vtkPVPluginTracker::GetInstance();
+  for (unsigned int cc = 0; cc < tracker->GetNumberOfPlugins(); cc++)
+  {
+    vtkPVPlugin* plugin = tracker->GetPlugin(cc);
+    if (plugin && strcmp(plugin->GetPluginName(), "vtkPVInitializerPlugin") == 0)
+    {
+      if (vtkPVServerManagerPluginInterface* smplugin =
+            dynamic_cast<vtkPVServerManagerPluginInterface*>(plugin))
+      {
+        smplugin->GetXMLs(xmls);
+      }
+      break;
+    }
+  }
+  if (xmls.empty())
+  {
+    cerr << "Could not find the ParaView configuration XMLs." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Both managers start with the core definitions, which are then loaded again
+  // lazily in one and parsed right away in the other.
+  vtkSmartPointer<vtkSIProxyDefinitionManager> lazyManager;
+  lazyManager.TakeReference(vtkSIProxyDefinitionManager::New());
+  vtkSmartPointer<vtkSIProxyDefinitionManager> eagerManager;
+  eagerManager.TakeReference(vtkSIProxyDefinitionManager::New());
+  for (size_t cc = 0; cc < xmls.size(); cc++)
+  {
+    lazyManager->LoadConfigurationXMLFromString(xmls[cc].c_str());
+
+    vtkNew<vtkPVXMLParser> parser;
+    if (!parser->Parse(xmls[cc].c_str()) ||
+      !eagerManager->LoadConfigurationXML(parser->GetRootElement()))
+    {
+      cerr << "Failed to parse configuration XML " << cc << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  int numberOfDefinitions = CountDefinitions(eagerManager);
+  if (numberOfDefinitions == 0 || numberOfDefinitions != CountDefinitions(lazyManager))
+  {
+    cerr << "Lazy and eager loading registered different definitions." << endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkPVProxyDefinitionIterator* iter =
+    eagerManager->NewIterator(vtkSIProxyDefinitionManager::CORE_DEFINITIONS);
+  for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    const char* group = iter->GetGroupName();
+    const char* name = iter->GetProxyName();
+    std::string expected = PrintDefinition(iter->GetProxyDefinition());
+    std::string actual = PrintDefinition(lazyManager->GetProxyDefinition(group, name, false));
+    if (expected.empty() || expected != actual)
+    {
+      cerr << "Definition of (" << group << ", " << name << ") differs:" << endl
+           << "Eager:" << endl
+           << expected << endl
+           << "Lazy:" << endl
+           << actual << endl;
+      iter->Delete();
+      return EXIT_FAILURE;
+    }
+  }
+  iter->Delete();
+
+  // Documents the scanner cannot split are fully parsed, so malformed ones
+  // are rejected.
+  const char* mismatched = "<ServerManagerConfiguration>"
+                           "  <ProxyGroup name=\"test_group\">"
+                           "    <Proxy name=\"TestProxy\" class=\"vtkObject\">"
+                           "  </ProxyGroup>"
+                           "    </Proxy>"
+                           "</ServerManagerConfiguration>";
+  vtkObject::GlobalWarningDisplayOff();
+  bool loaded = lazyManager->LoadConfigurationXMLFromString(mismatched);
+  vtkObject::GlobalWarningDisplayOn();
+  if (loaded || lazyManager->HasDefinition("test_group", "TestProxy"))
+  {
+    cerr << "A configuration with mismatched end tags was loaded." << endl;
+    return EXIT_FAILURE;
+  }
+
+  lazyManager = NULL;
+  eagerManager = NULL;
+  vtkInitializationHelper::Finalize();
+  return EXIT_SUCCESS;
+}
@@ -608,6 +608,14 @@ void vtkSMProxy::UpdateVTKObjects()
     return;
   }
 
+  // Send the states pushed by this proxy and its subproxies to the servers
+  // together.
+  vtkSMSession* session = this->GetSession();
+  if (session)
+  {
+    session->BeginPushBatch();
+  }
+
   if (this->PropertiesModified)
   {
     this->InUpdateVTKObjects = 1;
@@ -692,6 +700,11 @@ void vtkSMProxy::UpdateVTKObjects()
     it2->second.GetPointer()->UpdateVTKObjects();
   }
 
+  if (session)
+  {
+    session->EndPushBatch();
+  }
+
   this->MarkModified(this);
   this->InvokeEvent(vtkCommand::UpdateEvent, 0);
 }
@@ -145,6 +145,19 @@ public:
    */
   void PushState(vtkSMMessage* msg) VTK_OVERRIDE;
 
+  //@{
+  /**
+   * Begin/End a batch of state pushes. While batching, sessions connected to
+   * remote servers queue the states pushed by proxies and send them to each
+   * server as a single message when the batch ends, instead of sending one
+   * message per push. Batches can be nested, the queued pushes are sent when
+   * the outermost batch ends. Sessions that process everything locally
+   * ignore these calls.
+   */
+  virtual void BeginPushBatch() {}
+  virtual void EndPushBatch() {}
+  //@}
+
   /**
    * Sends the message to all clients.
    */
@@ -43,6 +43,7 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 #include <vtksys/RegularExpression.hxx>
 
 #include <assert.h>
@@ -60,6 +61,15 @@ void RMICallback(
   self->OnServerNotificationMessageRMI(remoteArg, remoteArgLength);
 }
 };
+
+// State pushes queued for the servers while batching.
+class vtkSMSessionClient::vtkPushBatch
+{
+public:
+  std::vector<std::string> DataServerMessages;
+  std::vector<std::string> RenderServerMessages;
+};
+
 //****************************************************************************/
 vtkStandardNewMacro(vtkSMSessionClient);
 vtkCxxSetObjectMacro(vtkSMSessionClient, RenderServerController, vtkMultiProcessController);
@@ -91,6 +101,8 @@ vtkSMSessionClient::vtkSMSessionClient()
   // Default value
   this->NoMoreDelete = false;
   this->NotBusy = 0;
+  this->PushBatchDepth = 0;
+  this->PendingPushes = new vtkSMSessionClient::vtkPushBatch();
 }
 
 //----------------------------------------------------------------------------
@@ -119,6 +131,9 @@ vtkSMSessionClient::~vtkSMSessionClient()
 
   delete this->ServerLastInvokeResult;
   this->ServerLastInvokeResult = NULL;
+
+  delete this->PendingPushes;
+  this->PendingPushes = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -436,6 +451,7 @@ bool vtkSMSessionClient::IsMPIInitialized(vtkTypeUInt32 servers)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::CloseSession()
 {
+  this->FlushPushBatch();
   if (this->DataServerController)
   {
     this->DataServerController->TriggerRMIOnAllChildren(vtkPVSessionServer::CLOSE_SESSION);
@@ -499,7 +515,24 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
   {
     controllers[num_controllers++] = this->RenderServerController;
   }
-  if (num_controllers > 0)
+  if (num_controllers > 0 && this->PushBatchDepth > 0)
+  {
+    // Queue the message, it is sent along with the other queued pushes when
+    // the batch ends or before any other message is sent to the servers.
+    std::string serialized = message->SerializeAsString();
+    for (int cc = 0; cc < num_controllers; cc++)
+    {
+      if (controllers[cc] == this->DataServerController)
+      {
+        this->PendingPushes->DataServerMessages.push_back(serialized);
+      }
+      else
+      {
+        this->PendingPushes->RenderServerMessages.push_back(serialized);
+      }
+    }
+  }
+  else if (num_controllers > 0)
   {
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::PUSH);
@@ -541,6 +574,9 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
         msg.set_share_only(true);
         msg.set_client_id(this->ServerInformation->GetClientId());
 
+        // Keep the order of the messages sent to the data-server.
+        this->FlushPushBatch();
+
         vtkMultiProcessStream stream;
         stream << static_cast<int>(vtkPVSessionServer::PUSH);
         stream << msg.SerializeAsString();
@@ -572,6 +608,7 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PullState(vtkSMMessage* message)
 {
+  this->FlushPushBatch();
   this->StartBusyWork();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
@@ -628,6 +665,7 @@ void vtkSMSessionClient::ExecuteStream(
     return;
   }
 
+  this->FlushPushBatch();
   location = this->GetRealLocation(location);
 
   vtkMultiProcessController* controllers[2] = { NULL, NULL };
@@ -671,6 +709,7 @@ void vtkSMSessionClient::ExecuteStream(
 //----------------------------------------------------------------------------
 const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 location)
 {
+  this->FlushPushBatch();
   this->StartBusyWork();
   location = this->GetRealLocation(location);
 
@@ -719,6 +758,7 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
 bool vtkSMSessionClient::GatherInformation(
   vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
 {
+  this->FlushPushBatch();
   this->StartBusyWork();
   if (this->RenderServerController == NULL)
   {
@@ -818,6 +858,8 @@ void vtkSMSessionClient::UnRegisterSIObject(vtkSMMessage* message)
     return;
   }
 
+  this->FlushPushBatch();
+
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
   message->set_client_id(this->GetServerInformation()->GetClientId());
@@ -859,6 +901,8 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
     return;
   }
 
+  this->FlushPushBatch();
+
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
   message->set_client_id(this->GetServerInformation()->GetClientId());
@@ -896,6 +940,53 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::BeginPushBatch()
+{
+  ++this->PushBatchDepth;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::EndPushBatch()
+{
+  if (this->PushBatchDepth > 0 && --this->PushBatchDepth == 0)
+  {
+    this->FlushPushBatch();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::FlushPushBatch()
+{
+  vtkMultiProcessController* controllers[2] = { this->DataServerController,
+    this->RenderServerController };
+  std::vector<std::string>* queues[2] = { &this->PendingPushes->DataServerMessages,
+    &this->PendingPushes->RenderServerMessages };
+  for (int cc = 0; cc < 2; cc++)
+  {
+    std::vector<std::string>& queue = *queues[cc];
+    if (queue.empty())
+    {
+      continue;
+    }
+    if (controllers[cc] && !this->NoMoreDelete)
+    {
+      vtkMultiProcessStream stream;
+      stream << static_cast<int>(vtkPVSessionServer::PUSH_BATCH)
+             << static_cast<int>(queue.size());
+      for (size_t kk = 0; kk < queue.size(); kk++)
+      {
+        stream << queue[kk];
+      }
+      std::vector<unsigned char> raw_message;
+      stream.GetRawData(raw_message);
+      controllers[cc]->TriggerRMIOnAllChildren(&raw_message[0],
+        static_cast<int>(raw_message.size()), vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    }
+    queue.clear();
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -106,6 +106,16 @@ public:
   const vtkClientServerStream& GetLastResult(vtkTypeUInt32 location) VTK_OVERRIDE;
   //@}
 
+  //@{
+  /**
+   * Overridden to queue the state pushes to the servers while batching. Any
+   * other message sent to the servers first flushes the queued pushes, so the
+   * servers process the messages in the order in which they were issued.
+   */
+  void BeginPushBatch() VTK_OVERRIDE;
+  void EndPushBatch() VTK_OVERRIDE;
+  //@}
+
   //@{
   /**
    * When Connect() is waiting for a server to connect back to the client (in
@@ -228,6 +238,12 @@ protected:
    */
   vtkTypeUInt32 GetRealLocation(vtkTypeUInt32);
 
+  /**
+   * Sends the state pushes queued while batching to the servers, one message
+   * per server.
+   */
+  void FlushPushBatch();
+
   // Both maybe the same when connected to pvserver.
   vtkMultiProcessController* RenderServerController;
   vtkMultiProcessController* DataServerController;
@@ -267,6 +283,9 @@ private:
   void operator=(const vtkSMSessionClient&) = delete;
 
   int NotBusy;
+  int PushBatchDepth;
+  class vtkPushBatch;
+  vtkPushBatch* PendingPushes;
   vtkTypeUInt32 LastGlobalID;
   vtkTypeUInt32 LastGlobalIDAvailable;
 };
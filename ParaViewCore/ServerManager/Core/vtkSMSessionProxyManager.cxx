@@ -1215,6 +1215,11 @@ void vtkSMSessionProxyManager::LoadXMLState(
 
   bool prev = this->InLoadXMLState;
   this->InLoadXMLState = true;
+  vtkSMSession* session = this->GetSession();
+  if (session)
+  {
+    session->BeginPushBatch();
+  }
   vtkSmartPointer<vtkSMStateLoader> spLoader;
   if (!loader)
   {
@@ -1232,6 +1237,10 @@ void vtkSMSessionProxyManager::LoadXMLState(
     info.ProxyLocator = spLoader->GetProxyLocator();
     this->InvokeEvent(vtkCommand::LoadStateEvent, &info);
   }
+  if (session)
+  {
+    session->EndPushBatch();
+  }
   this->InLoadXMLState = prev;
 }
 
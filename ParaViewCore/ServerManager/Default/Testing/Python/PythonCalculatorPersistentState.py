@@ -0,0 +1,65 @@
+# Checks that the PythonCalculator gives the same results with and without
+# PersistentState, including after its input or one block of a composite
+# input changed.
+
+from paraview.simple import *
+from paraview import smtesting
+from vtk.numpy_interface import dataset_adapter as dsa
+import numpy
+
+smtesting.ProcessCommandLineArguments()
+
+def get_results(calculator):
+    data = servermanager.Fetch(calculator)
+    array = dsa.WrapDataObject(data).PointData["result"]
+    if array is dsa.NoneArray:
+        raise smtesting.TestError("No result for %s" % calculator.Expression)
+    if isinstance(array, dsa.VTKCompositeDataArray):
+        return [numpy.array(a) for a in array.Arrays]
+    return [numpy.array(array)]
+
+def compare(persistent, plain, step):
+    expected = get_results(plain)
+    actual = get_results(persistent)
+    if len(expected) != len(actual) or \
+       not all(numpy.array_equal(e, a) for e, a in zip(expected, actual)):
+        raise smtesting.TestError("Results of '%s' differ %s." % (plain.Expression, step))
+
+sphere0 = Sphere(Radius=0.5)
+sphere1 = Sphere(Center=[2, 0, 0], Radius=0.25)
+group = GroupDatasets(Input=[sphere0, sphere1])
+
+expressions = ["mag(inputs[0].Points) * Normals[:,0]",
+               "Normals",
+               "Normals.reshape(-1)",
+               "inputs[0].Points + time_value"]
+
+for source in [sphere0, group]:
+    for expression in expressions:
+        persistent = PythonCalculator(Input=source, Expression=expression, PersistentState=1)
+        plain = PythonCalculator(Input=source, Expression=expression, PersistentState=0)
+        compare(persistent, plain, "on the initial input")
+
+        # Modify one leaf only: the composite input itself is not modified.
+        sphere1.Radius = 0.75
+        compare(persistent, plain, "after changing the radius")
+
+        sphere0.ThetaResolution = 16
+        sphere1.PhiResolution = 12
+        compare(persistent, plain, "after changing the resolution")
+
+        # Toggling the state and changing the expression must be handled too.
+        persistent.PersistentState = 0
+        sphere1.Radius = 0.25
+        compare(persistent, plain, "after turning the state off")
+
+        persistent.PersistentState = 1
+        sphere0.ThetaResolution = 8
+        sphere1.PhiResolution = 8
+        compare(persistent, plain, "after turning the state on again")
+
+        persistent.Expression = plain.Expression = "Normals[:,1] * 2"
+        compare(persistent, plain, "after changing the expression")
+
+        Delete(persistent)
+        Delete(plain)
@@ -0,0 +1,69 @@
+from __future__ import print_function
+
+import vtk
+from vtk.vtkPVVTKExtensionsCore import vtkIntegrateAttributes
+cntrl = vtk.vtkMultiProcessController.GetGlobalController()
+rank = cntrl.GetLocalProcessId()
+numprocs = cntrl.GetNumberOfProcesses()
+
+#-----------------------------------------------------------------------------
+# A unit cube at x = index with constant point and cell arrays, which
+# integrate to 2 and 3.
+def get_piece(index):
+    image = vtk.vtkImageData()
+    image.SetDimensions(3, 3, 3)
+    image.SetSpacing(0.5, 0.5, 0.5)
+    image.SetOrigin(index, 0, 0)
+
+    array = vtk.vtkDoubleArray()
+    array.SetName("pa")
+    array.SetNumberOfTuples(image.GetNumberOfPoints())
+    array.FillComponent(0, 2)
+    image.GetPointData().AddArray(array)
+
+    array = vtk.vtkDoubleArray()
+    array.SetName("ca")
+    array.SetNumberOfTuples(image.GetNumberOfCells())
+    array.FillComponent(0, 3)
+    image.GetCellData().AddArray(array)
+    return image
+
+def check(result, pieces):
+    if rank != 0:
+        assert result.GetNumberOfPoints() == 0
+        return
+    assert result.GetNumberOfPoints() == 1
+    volume = result.GetCellData().GetArray("Volume")
+    pa = result.GetPointData().GetArray("pa")
+    ca = result.GetCellData().GetArray("ca")
+    assert volume is not None and pa is not None and ca is not None
+    assert abs(volume.GetValue(0) - len(pieces)) < 1e-10
+    assert abs(pa.GetValue(0) - 2 * len(pieces)) < 1e-10
+    assert abs(ca.GetValue(0) - 3 * len(pieces)) < 1e-10
+    center = sum(pieces) / float(len(pieces)) + 0.5
+    assert abs(result.GetPoint(0)[0] - center) < 1e-10
+
+integrate = vtkIntegrateAttributes()
+integrate.SetController(cntrl)
+
+#-----------------------------------------------------------------------------
+if rank == 0:
+    print("Testing with data on every rank")
+
+integrate.SetInputDataObject(get_piece(rank))
+integrate.Update()
+check(integrate.GetOutputDataObject(0), list(range(numprocs)))
+
+#-----------------------------------------------------------------------------
+# Rank 0 has an empty piece, without any arrays. The arrays and the volume
+# must still be reduced from the other ranks.
+if numprocs > 1:
+    if rank == 0:
+        print("Testing with an empty piece on rank 0")
+        integrate.SetInputDataObject(vtk.vtkUnstructuredGrid())
+    # Every rank must execute to take part in the reduction.
+    integrate.Modified()
+    integrate.Update()
+    check(integrate.GetOutputDataObject(0), list(range(1, numprocs)))
+
+print("%d-Passed!" % rank)
@@ -0,0 +1,50 @@
+from __future__ import print_function
+
+import vtk
+from vtk.vtkPVVTKExtensionsCore import vtkReductionFilter
+cntrl = vtk.vtkMultiProcessController.GetGlobalController()
+rank = cntrl.GetLocalProcessId()
+numprocs = cntrl.GetNumberOfProcesses()
+
+#-----------------------------------------------------------------------------
+# A polydata with rank + 1 vertices at x = rank, so that the order in which
+# the pieces were appended can be read back from the points.
+def get_piece():
+    points = vtk.vtkPoints()
+    verts = vtk.vtkCellArray()
+    for i in range(rank + 1):
+        verts.InsertNextCell(1)
+        verts.InsertCellPoint(points.InsertNextPoint(rank, i, 0))
+    piece = vtk.vtkPolyData()
+    piece.SetPoints(points)
+    piece.SetVerts(verts)
+    return piece
+
+def reduce_piece(mode, root, fanIn):
+    reduction = vtkReductionFilter()
+    reduction.SetController(cntrl)
+    reduction.SetPostGatherHelper(vtk.vtkAppendPolyData())
+    reduction.SetReductionMode(mode)
+    reduction.SetReductionProcessId(root)
+    reduction.SetTreeFanIn(fanIn)
+    reduction.SetInputDataObject(get_piece())
+    reduction.Update()
+    output = reduction.GetOutputDataObject(0)
+    return [output.GetPoint(i) for i in range(output.GetNumberOfPoints())]
+
+#-----------------------------------------------------------------------------
+for mode in [vtkReductionFilter.REDUCE_ALL_TO_ONE, vtkReductionFilter.MOVE_ALL_TO_ONE]:
+    for root in range(numprocs):
+        expected = reduce_piece(mode, root, 0)
+        if rank == root:
+            # the flat gather appends the pieces in process order.
+            assert [p[0] for p in expected] == \
+                [r for r in range(numprocs) for i in range(r + 1)]
+        for fanIn in [2, 3]:
+            actual = reduce_piece(mode, root, fanIn)
+            if actual != expected:
+                print("Mode %d, root %d, fan-in %d: tree output differs on rank %d" %
+                      (mode, root, fanIn, rank))
+                assert False
+
+print("%d-Passed!" % rank)
@@ -24,6 +24,7 @@
 #include "vtkDataArraySelection.h"
 #include "vtkDoubleArray.h"
 #include "vtkErrorCode.h"
+#include "vtkExtentTranslator.h"
 #include "vtkExtractGrid.h"
 #include "vtkFloatArray.h"
 #include "vtkIdTypeArray.h"
@@ -371,6 +372,7 @@ vtkCGNSReader::vtkCGNSReader()
   this->CreateEachSolutionAsBlock = 0;
   this->IgnoreFlowSolutionPointers = false;
   this->DistributeBlocks = true;
+  this->SplitStructuredZones = false;
   this->IgnoreSILChangeEvents = false;
 
   // Setup the selection callback to modify this object when an array
@@ -1358,8 +1360,8 @@ vtkSmartPointer<vtkDataObject> vtkCGNSReader::vtkPrivate::readCurvilinearZone(in
 }
 
 //------------------------------------------------------------------------------
-int vtkCGNSReader::GetCurvilinearZone(
-  int base, int zone, int cellDim, int physicalDim, void* v_zsize, vtkMultiBlockDataSet* mbase)
+int vtkCGNSReader::GetCurvilinearZone(int base, int zone, int cellDim, int physicalDim,
+  void* v_zsize, vtkMultiBlockDataSet* mbase, const int* voi)
 {
   cgsize_t* zsize = reinterpret_cast<cgsize_t*>(v_zsize);
 
@@ -1368,10 +1370,15 @@ int vtkCGNSReader::GetCurvilinearZone(
   const char* zonename = this->Internal->GetBase(base).zones[zone].name;
 
   vtkSmartPointer<vtkDataObject> zoneDO = sil->ReadGridForZone(basename, zonename)
-    ? vtkPrivate::readCurvilinearZone(base, zone, cellDim, physicalDim, zsize, nullptr, this)
+    ? vtkPrivate::readCurvilinearZone(base, zone, cellDim, physicalDim, zsize, voi, this)
     : vtkSmartPointer<vtkDataObject>();
   mbase->SetBlock(zone, zoneDO.Get());
 
+  // When the zone is split among ranks, the patches are read from the file by
+  // the rank holding the first block of the zone. The other ranks add empty
+  // blocks so that all ranks produce the same structure.
+  const bool readPatches = voi == nullptr || (voi[0] == 0 && voi[2] == 0 && voi[4] == 0);
+
   //----------------------------------------------------------------------------
   // Handle boundary conditions (BC) patches
   //----------------------------------------------------------------------------
@@ -1416,9 +1423,13 @@ int vtkCGNSReader::GetCurvilinearZone(
             if (sil->ReadPatch(basename, zonename, binfo.Name))
             {
               const unsigned int idx = patchesMB->GetNumberOfBlocks();
-              vtkSmartPointer<vtkDataSet> ds = zoneGrid
-                ? binfo.CreateDataSet(cellDim, zoneGrid)
-                : vtkPrivate::readBCDataSet(binfo, base, zone, cellDim, physicalDim, zsize, this);
+              vtkSmartPointer<vtkDataSet> ds;
+              if (readPatches)
+              {
+                ds = zoneGrid && voi == nullptr
+                  ? binfo.CreateDataSet(cellDim, zoneGrid)
+                  : vtkPrivate::readBCDataSet(binfo, base, zone, cellDim, physicalDim, zsize, this);
+              }
               vtkPrivate::AddIsPatchArray(ds, true);
               patchesMB->SetBlock(idx, ds);
 
@@ -2584,6 +2595,19 @@ int vtkCGNSReader::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
+  // When splitting structured zones, every rank reads a block of each
+  // structured zone and unstructured zones are assigned to ranks in turn.
+  const bool splitZones = this->SplitStructuredZones && numProcessors > 1;
+  if (splitZones)
+  {
+    for (int bb = 0; bb < numBases; bb++)
+    {
+      baseToZoneRange[bb][0] = 0;
+      baseToZoneRange[bb][1] = this->Internal->GetBase(bb).nzones;
+    }
+  }
+  int zoneOffset = 0;
+
   // Bnd Sections Not implemented yet for parallel
   if (numProcessors > 1)
   {
@@ -2756,6 +2780,8 @@ int vtkCGNSReader::RequestData(vtkInformation* vtkNotUsed(request),
 
     int zonemin = baseToZoneRange[numBase][0];
     int zonemax = baseToZoneRange[numBase][1];
+    const int baseZoneOffset = zoneOffset;
+    zoneOffset += curBaseInfo.nzones;
     for (int zone = zonemin; zone < zonemax; ++zone)
     {
       CGNSRead::char_33 zoneName;
@@ -2864,7 +2890,28 @@ int vtkCGNSReader::RequestData(vtkInformation* vtkNotUsed(request),
           break;
         case CGNS_ENUMV(Structured):
         {
-          ier = GetCurvilinearZone(numBase, zone, cellDim, physicalDim, zsize, mbase);
+          if (splitZones)
+          {
+            // split the cells of the zone in blocks, neighboring blocks share
+            // their boundary points.
+            int wholeExtent[6] = { 0, 0, 0, 0, 0, 0 };
+            for (int n = 0; n < cellDim; ++n)
+            {
+              wholeExtent[2 * n + 1] = static_cast<int>(zsize[n]) - 1;
+            }
+            int voi[6];
+            if (!vtkExtentTranslator::PieceToExtentThreadSafe(processNumber, numProcessors, 0,
+                  wholeExtent, voi, vtkExtentTranslator::BLOCK_MODE, 0))
+            {
+              // more ranks than cells in this zone.
+              break;
+            }
+            ier = GetCurvilinearZone(numBase, zone, cellDim, physicalDim, zsize, mbase, voi);
+          }
+          else
+          {
+            ier = GetCurvilinearZone(numBase, zone, cellDim, physicalDim, zsize, mbase);
+          }
           if (ier != CG_OK)
           {
             vtkErrorMacro(<< "Error Reading file");
@@ -2874,6 +2921,10 @@ int vtkCGNSReader::RequestData(vtkInformation* vtkNotUsed(request),
           break;
         }
         case CGNS_ENUMV(Unstructured):
+          if (splitZones && (baseZoneOffset + zone) % numProcessors != processNumber)
+          {
+            break;
+          }
           ier = GetUnstructuredZone(numBase, zone, cellDim, physicalDim, zsize, mbase);
           if (ier != CG_OK)
           {
@@ -3003,6 +3054,7 @@ void vtkCGNSReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "CreateEachSolutionAsBlock: " << this->CreateEachSolutionAsBlock << endl;
   os << indent << "IgnoreFlowSolutionPointers: " << this->IgnoreFlowSolutionPointers << endl;
   os << indent << "DistributeBlocks: " << this->DistributeBlocks << endl;
+  os << indent << "SplitStructuredZones: " << this->SplitStructuredZones << endl;
   os << indent << "Controller: " << this->Controller << endl;
 }
 
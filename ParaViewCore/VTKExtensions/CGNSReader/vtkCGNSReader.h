@@ -209,6 +209,17 @@ public:
   vtkGetMacro(DistributeBlocks, bool);
   vtkBooleanMacro(DistributeBlocks, bool);
 
+  /**
+   * When distributing blocks across ranks, split each structured zone in
+   * i/j/k blocks among all the ranks instead of assigning whole zones to
+   * ranks, so that the cells are evenly distributed even when the file has
+   * few large zones. Unstructured zones are then assigned to the ranks in
+   * turn. Default is false.
+   */
+  vtkSetMacro(SplitStructuredZones, bool);
+  vtkGetMacro(SplitStructuredZones, bool);
+  vtkBooleanMacro(SplitStructuredZones, bool);
+
   //@{
   /**
    * Set/get the communication object used to relay a list of files
@@ -250,8 +261,12 @@ protected:
   static void SelectionModifiedCallback(
     vtkObject* caller, unsigned long eid, void* clientdata, void* calldata);
 
-  int GetCurvilinearZone(
-    int base, int zone, int cell_dim, int phys_dim, void* zsize, vtkMultiBlockDataSet* mbase);
+  /**
+   * Reads a structured zone. When voi is not NULL, only the points in this
+   * sub-extent of the zone are read.
+   */
+  int GetCurvilinearZone(int base, int zone, int cell_dim, int phys_dim, void* zsize,
+    vtkMultiBlockDataSet* mbase, const int* voi = nullptr);
 
   int GetUnstructuredZone(
     int base, int zone, int cell_dim, int phys_dim, void* zsize, vtkMultiBlockDataSet* mbase);
@@ -280,6 +295,7 @@ private:
   int CreateEachSolutionAsBlock; // debug option to create
   bool IgnoreFlowSolutionPointers;
   bool DistributeBlocks;
+  bool SplitStructuredZones;
 
   // For internal cgio calls (low level IO)
   int cgioNum;      // cgio file reference
@@ -32,6 +32,8 @@
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -41,10 +43,14 @@
 #include "vtkSmartPointer.h"
 #define VTK_CREATE(type, name) vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
+#include <vtksys/SystemTools.hxx>
+
 #include <algorithm>
 #include <ctype.h> // for isprint().
+#include <iomanip>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -353,6 +359,169 @@ public:
 private:
   void operator=(const vtkRecordMTime&);
 };
+
+// Time information reported by the reader for one file of the series.
+class vtkFileSeriesReaderFileTime
+{
+public:
+  vtkFileSeriesReaderFileTime()
+    : HasTimeSteps(false)
+    , HasTimeRange(false)
+  {
+    this->TimeRange[0] = this->TimeRange[1] = 0.0;
+  }
+
+  void CopyFrom(vtkInformation* info)
+  {
+    this->HasTimeSteps = info->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()) != 0;
+    this->TimeSteps.clear();
+    if (this->HasTimeSteps)
+    {
+      double* timeSteps = info->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+      int numTimeSteps = info->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+      this->TimeSteps.assign(timeSteps, timeSteps + numTimeSteps);
+    }
+    this->HasTimeRange = info->Has(vtkStreamingDemandDrivenPipeline::TIME_RANGE()) != 0;
+    if (this->HasTimeRange)
+    {
+      info->Get(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), this->TimeRange);
+    }
+  }
+
+  void CopyTo(vtkInformation* info) const
+  {
+    info->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    info->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+    if (this->HasTimeSteps && !this->TimeSteps.empty())
+    {
+      info->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), &this->TimeSteps[0],
+        static_cast<int>(this->TimeSteps.size()));
+    }
+    if (this->HasTimeRange)
+    {
+      info->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), this->TimeRange, 2);
+    }
+  }
+
+  void Save(vtkMultiProcessStream& stream) const
+  {
+    stream << static_cast<int>(this->HasTimeSteps) << static_cast<int>(this->TimeSteps.size());
+    for (size_t cc = 0; cc < this->TimeSteps.size(); cc++)
+    {
+      stream << this->TimeSteps[cc];
+    }
+    stream << static_cast<int>(this->HasTimeRange) << this->TimeRange[0] << this->TimeRange[1];
+  }
+
+  void Load(vtkMultiProcessStream& stream)
+  {
+    int hasTimeSteps, numTimeSteps, hasTimeRange;
+    stream >> hasTimeSteps >> numTimeSteps;
+    this->HasTimeSteps = hasTimeSteps != 0;
+    this->TimeSteps.resize(numTimeSteps);
+    for (int cc = 0; cc < numTimeSteps; cc++)
+    {
+      stream >> this->TimeSteps[cc];
+    }
+    stream >> hasTimeRange >> this->TimeRange[0] >> this->TimeRange[1];
+    this->HasTimeRange = hasTimeRange != 0;
+  }
+
+  bool HasTimeSteps;
+  std::vector<double> TimeSteps;
+  bool HasTimeRange;
+  double TimeRange[2];
+};
+
+// An entry of the time index file. The saved time information is used only if
+// the size and modification time of the file did not change. Modification
+// times have a resolution of one second, so a file rewritten with the same
+// size within the second it was indexed would look unchanged: entries of files
+// modified in or after the second the index file was written are ignored.
+struct vtkFileSeriesReaderIndexEntry
+{
+  unsigned long FileLength;
+  long ModifiedTime;
+  vtkFileSeriesReaderFileTime Time;
+
+  bool Stat(const std::string& fname)
+  {
+    if (!vtksys::SystemTools::FileExists(fname.c_str(), true))
+    {
+      return false;
+    }
+    this->FileLength = vtksys::SystemTools::FileLength(fname.c_str());
+    this->ModifiedTime = vtksys::SystemTools::ModifiedTime(fname.c_str());
+    return true;
+  }
+};
+
+typedef std::map<std::string, vtkFileSeriesReaderIndexEntry> vtkFileSeriesReaderIndex;
+
+const char* const vtkFileSeriesReaderIndexHeader = "# vtkFileSeriesReader time index 1";
+
+// The index file lists the name of the reader followed by two lines per file:
+// the file name, then its size, modification time and time information.
+void vtkFileSeriesReaderReadIndex(
+  const char* indexFileName, const char* readerName, vtkFileSeriesReaderIndex& index)
+{
+  ifstream indexFile(indexFileName);
+  std::string header, name, fname, line;
+  if (!std::getline(indexFile, header) || header != vtkFileSeriesReaderIndexHeader ||
+    !std::getline(indexFile, name) || name != readerName)
+  {
+    return;
+  }
+  const long indexTime = vtksys::SystemTools::ModifiedTime(indexFileName);
+  while (std::getline(indexFile, fname) && std::getline(indexFile, line))
+  {
+    std::istringstream entryStream(line);
+    vtkFileSeriesReaderIndexEntry entry;
+    vtkFileSeriesReaderFileTime& time = entry.Time;
+    int hasTimeSteps = 0, numTimeSteps = 0, hasTimeRange = 0;
+    entryStream >> entry.FileLength >> entry.ModifiedTime >> hasTimeSteps >> numTimeSteps;
+    time.HasTimeSteps = hasTimeSteps != 0;
+    time.TimeSteps.resize(numTimeSteps > 0 ? numTimeSteps : 0);
+    for (size_t cc = 0; cc < time.TimeSteps.size(); cc++)
+    {
+      entryStream >> time.TimeSteps[cc];
+    }
+    entryStream >> hasTimeRange >> time.TimeRange[0] >> time.TimeRange[1];
+    time.HasTimeRange = hasTimeRange != 0;
+    if (!entryStream.fail() && entry.ModifiedTime < indexTime)
+    {
+      index[fname] = entry;
+    }
+  }
+}
+
+void vtkFileSeriesReaderWriteIndex(
+  const char* indexFileName, const char* readerName, const vtkFileSeriesReaderIndex& index)
+{
+  ofstream indexFile(indexFileName);
+  if (!indexFile)
+  {
+    vtkGenericWarningMacro("Could not write time index file " << indexFileName);
+    return;
+  }
+  indexFile << vtkFileSeriesReaderIndexHeader << "\n" << readerName << "\n";
+  indexFile << std::setprecision(17);
+  for (vtkFileSeriesReaderIndex::const_iterator iter = index.begin(); iter != index.end(); ++iter)
+  {
+    const vtkFileSeriesReaderFileTime& time = iter->second.Time;
+    indexFile << iter->first << "\n"
+              << iter->second.FileLength << " " << iter->second.ModifiedTime << " "
+              << time.HasTimeSteps << " " << time.TimeSteps.size();
+    for (size_t cc = 0; cc < time.TimeSteps.size(); cc++)
+    {
+      indexFile << " " << time.TimeSteps[cc];
+    }
+    indexFile << " " << time.HasTimeRange << " " << time.TimeRange[0] << " " << time.TimeRange[1]
+              << "\n";
+  }
+}
+
+const int FILE_SERIES_TIME_TAG = 983298;
 }
 
 //=============================================================================
@@ -376,6 +545,10 @@ vtkFileSeriesReader::vtkFileSeriesReader()
   this->UseMetaFile = 0;
 
   this->IgnoreReaderTime = 0;
+
+  this->TimeIndexFileName = NULL;
+
+  this->Controller = NULL;
 }
 
 //-----------------------------------------------------------------------------
@@ -383,8 +556,13 @@ vtkFileSeriesReader::~vtkFileSeriesReader()
 {
   delete this->Internal->TimeRanges;
   delete this->Internal;
+  this->SetTimeIndexFileName(NULL);
+  this->SetController(NULL);
 }
 
+//----------------------------------------------------------------------------
+vtkCxxSetObjectMacro(vtkFileSeriesReader, Controller, vtkMultiProcessController);
+
 //----------------------------------------------------------------------------
 void vtkFileSeriesReader::AddFileName(const char* name)
 {
@@ -574,11 +752,7 @@ int vtkFileSeriesReader::RequestInformation(vtkInformation* request,
     this->Internal->TimeRanges->AddTimeRange(0, outInfo);
 
     // Query all the other files for time info.
-    for (int i = 1; i < numFiles; i++)
-    {
-      this->RequestInformationForInput(i, request, outputVector);
-      this->Internal->TimeRanges->AddTimeRange(i, outInfo);
-    }
+    this->CollectTimeRanges(request, outputVector, outInfo);
   }
 
   // Now that we have collected all of the time information, set the aggregate
@@ -587,6 +761,153 @@ int vtkFileSeriesReader::RequestInformation(vtkInformation* request,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkFileSeriesReader::CollectTimeRanges(
+  vtkInformation* request, vtkInformationVector* outputVector, vtkInformation* outInfo)
+{
+  int numFiles = static_cast<int>(this->GetNumberOfFileNames());
+  const std::vector<std::string>& fileNames = this->Internal->FileNames;
+  std::vector<vtkFileSeriesReaderFileTime> times(numFiles);
+
+  vtkMultiProcessController* controller = this->Controller;
+  int numProcs = controller ? controller->GetNumberOfProcesses() : 1;
+  int myId = controller ? controller->GetLocalProcessId() : 0;
+
+  // The root process looks up the files that did not change since the index
+  // was written and decides which files need to be opened.
+  bool useIndex = this->TimeIndexFileName && this->TimeIndexFileName[0];
+  vtkFileSeriesReaderIndex index;
+  std::vector<int> toScan;
+  if (myId == 0)
+  {
+    vtkFileSeriesReaderIndex savedIndex;
+    if (useIndex)
+    {
+      vtkFileSeriesReaderReadIndex(
+        this->TimeIndexFileName, this->Reader->GetClassName(), savedIndex);
+    }
+    for (int i = 1; i < numFiles; i++)
+    {
+      vtkFileSeriesReaderIndexEntry entry;
+      if (!useIndex || !entry.Stat(fileNames[i]))
+      {
+        toScan.push_back(i);
+        continue;
+      }
+      vtkFileSeriesReaderIndex::iterator iter = savedIndex.find(fileNames[i]);
+      if (iter != savedIndex.end() && iter->second.FileLength == entry.FileLength &&
+        iter->second.ModifiedTime == entry.ModifiedTime)
+      {
+        times[i] = iter->second.Time;
+      }
+      else
+      {
+        toScan.push_back(i);
+      }
+      index[fileNames[i]] = entry;
+    }
+  }
+  if (numProcs > 1)
+  {
+    vtkMultiProcessStream stream;
+    if (myId == 0)
+    {
+      stream << static_cast<int>(toScan.size());
+      for (size_t cc = 0; cc < toScan.size(); cc++)
+      {
+        stream << toScan[cc];
+      }
+    }
+    controller->Broadcast(stream, 0);
+    if (myId != 0)
+    {
+      int numToScan;
+      stream >> numToScan;
+      toScan.resize(numToScan);
+      for (int cc = 0; cc < numToScan; cc++)
+      {
+        stream >> toScan[cc];
+      }
+    }
+  }
+
+  // Open the files missing from the index, each process opening its share.
+  vtkMultiProcessStream scanned;
+  for (size_t cc = myId; cc < toScan.size(); cc += numProcs)
+  {
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+    this->RequestInformationForInput(toScan[cc], request, outputVector);
+    times[toScan[cc]].CopyFrom(outInfo);
+    times[toScan[cc]].Save(scanned);
+  }
+
+  if (numProcs > 1)
+  {
+    // Collect the time information on the root process and send all of it back.
+    if (myId == 0)
+    {
+      for (int proc = 1; proc < numProcs; proc++)
+      {
+        vtkMultiProcessStream received;
+        controller->Receive(received, proc, FILE_SERIES_TIME_TAG);
+        for (size_t cc = proc; cc < toScan.size(); cc += numProcs)
+        {
+          times[toScan[cc]].Load(received);
+        }
+      }
+    }
+    else
+    {
+      controller->Send(scanned, 0, FILE_SERIES_TIME_TAG);
+    }
+
+    vtkMultiProcessStream stream;
+    if (myId == 0)
+    {
+      for (int i = 1; i < numFiles; i++)
+      {
+        times[i].Save(stream);
+      }
+    }
+    controller->Broadcast(stream, 0);
+    if (myId != 0)
+    {
+      for (int i = 1; i < numFiles; i++)
+      {
+        times[i].Load(stream);
+      }
+    }
+  }
+
+  if (myId == 0 && useIndex && !toScan.empty())
+  {
+    for (int i = 1; i < numFiles; i++)
+    {
+      vtkFileSeriesReaderIndex::iterator iter = index.find(fileNames[i]);
+      if (iter != index.end())
+      {
+        iter->second.Time = times[i];
+      }
+    }
+    vtkFileSeriesReaderWriteIndex(this->TimeIndexFileName, this->Reader->GetClassName(), index);
+  }
+
+  VTK_CREATE(vtkInformation, timeInfo);
+  for (int i = 1; i < numFiles; i++)
+  {
+    times[i].CopyTo(timeInfo);
+    this->Internal->TimeRanges->AddTimeRange(i, timeInfo);
+  }
+
+  // Leave the reader on the last file, with its information in outInfo, on
+  // all processes as when every file is opened in turn.
+  if (numFiles > 1 && this->_FileIndex != numFiles - 1)
+  {
+    this->RequestInformationForInput(numFiles - 1, request, outputVector);
+  }
+}
+
 //----------------------------------------------------------------------------
 int vtkFileSeriesReader::RequestUpdateExtent(vtkInformation* request,
   vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
@@ -794,6 +1115,9 @@ void vtkFileSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
      << endl;
   os << indent << "UseMetaFile: " << this->UseMetaFile << endl;
   os << indent << "IgnoreReaderTime: " << this->IgnoreReaderTime << endl;
+  os << indent << "TimeIndexFileName: "
+     << (this->TimeIndexFileName ? this->TimeIndexFileName : "(none)") << endl;
+  os << indent << "Controller: " << this->Controller << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -45,6 +45,11 @@
  * method is useful when the actual reader points to a set of files itself.  The
  * UseMetaFile toggles between these two methods of specifying files.
  *
+ * When a Controller is set, the files are distributed among its processes to
+ * collect their time information. The time information can also be saved in
+ * an index file (see TimeIndexFileName) so that the files are not opened again
+ * the next time the same series is read.
+ *
 */
 
 #ifndef vtkFileSeriesReader_h
@@ -53,6 +58,7 @@
 #include "vtkMetaReader.h"
 #include "vtkPVVTKExtensionsCoreModule.h" //needed for exports
 
+class vtkMultiProcessController;
 class vtkStringArray;
 
 struct vtkFileSeriesReaderInternals;
@@ -119,6 +125,30 @@ public:
   vtkBooleanMacro(IgnoreReaderTime, int);
   //@}
 
+  //@{
+  /**
+   * Name of a file used to save the time information of the files in the
+   * series, along with the size and modification time of each file. When set,
+   * RequestInformation uses the saved time information of the files that did
+   * not change instead of opening them, and updates the file with the time
+   * information of the other files. Since modification times are only
+   * compared to the second, files modified in the same second as the index
+   * file was written are always opened again. Not set by default.
+   */
+  vtkSetStringMacro(TimeIndexFileName);
+  vtkGetStringMacro(TimeIndexFileName);
+  //@}
+
+  //@{
+  /**
+   * Controller used to distribute the collection of the time information of
+   * the files among the processes. When NULL (the default), all the files are
+   * scanned by this process only.
+   */
+  virtual void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+  //@}
+
 protected:
   vtkFileSeriesReader();
   ~vtkFileSeriesReader() override;
@@ -177,8 +207,21 @@ protected:
 
   int IgnoreReaderTime;
 
+  char* TimeIndexFileName;
+
+  vtkMultiProcessController* Controller;
+
   int ChooseInput(vtkInformation*);
 
+  /**
+   * Collects the time information of all the files but the first one, whose
+   * information is already in outInfo, and adds it to the time ranges. The
+   * files missing from the time index are distributed among the processes of
+   * the Controller.
+   */
+  void CollectTimeRanges(
+    vtkInformation* request, vtkInformationVector* outputVector, vtkInformation* outInfo);
+
 private:
   vtkFileSeriesReader(const vtkFileSeriesReader&) = delete;
   void operator=(const vtkFileSeriesReader&) = delete;
@@ -21,21 +21,36 @@
 #include "vtkCompositeDataSet.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTriangle.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <string>
+#include <vector>
+
 vtkStandardNewMacro(vtkIntegrateAttributes);
 
+namespace
+{
+// Blocks with fewer cells are not worth integrating with threads.
+const vtkIdType vtkIntegrateAttributesCellsPerThread = 10000;
+}
+
 class vtkIntegrateAttributes::vtkFieldList : public vtkDataSetAttributes::FieldList
 {
   typedef vtkDataSetAttributes::FieldList Superclass;
@@ -146,25 +161,133 @@ int vtkIntegrateAttributes::CompareIntegrationDimension(vtkDataSet* output, int
   return (this->IntegrationDimension == dim);
 }
 
+//----------------------------------------------------------------------------
+// Integrates ranges of cells concurrently. Every thread accumulates into its
+// own instance of the filter and its own copy of the output attributes, which
+// are summed into the filter executing the block when all cells are done.
+class vtkIntegrateAttributes::vtkIntegrateCellsFunctor
+{
+public:
+  vtkIntegrateCellsFunctor(
+    vtkIntegrateAttributes* self, vtkDataSet* input, vtkUnstructuredGrid* output)
+    : Self(self)
+    , Input(input)
+    , Output(output)
+  {
+  }
+
+  void Initialize()
+  {
+    LocalData& local = this->Locals.Local();
+    local.Filter = vtkSmartPointer<vtkIntegrateAttributes>::New();
+    local.Filter->PointFieldList = this->Self->PointFieldList;
+    local.Filter->CellFieldList = this->Self->CellFieldList;
+    local.Filter->FieldListIndex = this->Self->FieldListIndex;
+    local.Filter->IntegrationDimension = this->Self->IntegrationDimension;
+    local.Output = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    local.Output->GetPointData()->DeepCopy(this->Output->GetPointData());
+    local.Output->GetCellData()->DeepCopy(this->Output->GetCellData());
+    local.Filter->ZeroAttributes(local.Output->GetPointData());
+    local.Filter->ZeroAttributes(local.Output->GetCellData());
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    LocalData& local = this->Locals.Local();
+    local.Filter->IntegrateCells(this->Input, local.Output, begin, end);
+  }
+
+  void Reduce()
+  {
+    vtkSMPThreadLocal<LocalData>::iterator iter;
+    for (iter = this->Locals.begin(); iter != this->Locals.end(); ++iter)
+    {
+      vtkIntegrateAttributes* filter = (*iter).Filter;
+      if (filter->IntegrationDimension == 0 ||
+        !this->Self->CompareIntegrationDimension(this->Output, filter->IntegrationDimension))
+      {
+        continue;
+      }
+      this->Self->Sum += filter->Sum;
+      this->Self->SumCenter[0] += filter->SumCenter[0];
+      this->Self->SumCenter[1] += filter->SumCenter[1];
+      this->Self->SumCenter[2] += filter->SumCenter[2];
+      AddArrays((*iter).Output->GetPointData(), this->Output->GetPointData());
+      AddArrays((*iter).Output->GetCellData(), this->Output->GetCellData());
+    }
+  }
+
+private:
+  struct LocalData
+  {
+    vtkSmartPointer<vtkIntegrateAttributes> Filter;
+    vtkSmartPointer<vtkUnstructuredGrid> Output;
+  };
+
+  // Both attributes have the same arrays, in the same order.
+  static void AddArrays(vtkDataSetAttributes* from, vtkDataSetAttributes* to)
+  {
+    for (int i = 0; i < to->GetNumberOfArrays(); ++i)
+    {
+      vtkDataArray* inArray = from->GetArray(i);
+      vtkDataArray* outArray = to->GetArray(i);
+      for (int j = 0; j < outArray->GetNumberOfComponents(); ++j)
+      {
+        outArray->SetComponent(0, j, outArray->GetComponent(0, j) + inArray->GetComponent(0, j));
+      }
+    }
+  }
+
+  vtkIntegrateAttributes* Self;
+  vtkDataSet* Input;
+  vtkUnstructuredGrid* Output;
+  vtkSMPThreadLocal<LocalData> Locals;
+};
+
 //----------------------------------------------------------------------------
 void vtkIntegrateAttributes::ExecuteBlock(vtkDataSet* input, vtkUnstructuredGrid* output,
   int fieldset_index, vtkIntegrateAttributes::vtkFieldList& pdList,
   vtkIntegrateAttributes::vtkFieldList& cdList)
 {
-  vtkUnsignedCharArray* ghostArray = input->GetCellGhostArray();
-
   // This is sort of a hack since it's incredibly painful to change all the
   // signatures to take the pdList, cdList and fieldset_index.
   this->PointFieldList = &pdList;
   this->CellFieldList = &cdList;
   this->FieldListIndex = fieldset_index;
 
-  vtkIdList* cellPtIds = vtkIdList::New();
   vtkIdType numCells = input->GetNumberOfCells();
+  if (numCells < vtkIntegrateAttributesCellsPerThread)
+  {
+    this->IntegrateCells(input, output, 0, numCells);
+  }
+  else
+  {
+    // Getting a cell once makes sure that the structures some datasets build
+    // lazily (e.g. vtkPolyData cells) exist before the threads start.
+    vtkNew<vtkGenericCell> cell;
+    input->GetCell(0, cell.GetPointer());
+
+    vtkIntegrateCellsFunctor functor(this, input, output);
+    vtkSMPTools::For(0, numCells, vtkIntegrateAttributesCellsPerThread, functor);
+  }
+
+  this->PointFieldList = NULL;
+  this->CellFieldList = NULL;
+  this->FieldListIndex = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkIntegrateAttributes::IntegrateCells(
+  vtkDataSet* input, vtkUnstructuredGrid* output, vtkIdType begin, vtkIdType end)
+{
+  vtkUnsignedCharArray* ghostArray = input->GetCellGhostArray();
+
+  vtkIdList* cellPtIds = vtkIdList::New();
+  vtkGenericCell* cell = vtkGenericCell::New();
   vtkIdType cellId;
   vtkPoints* cellPoints = 0; // needed if we need to split 3D cells
   int cellType;
-  for (cellId = 0; cellId < numCells; ++cellId)
+  for (cellId = begin; cellId < end; ++cellId)
   {
     cellType = input->GetCellType(cellId);
     // Make sure we are not integrating ghost/blanked cells.
@@ -278,7 +401,7 @@ void vtkIntegrateAttributes::ExecuteBlock(vtkDataSet* input, vtkUnstructuredGrid
       default:
       {
         // We need to explicitly get the cell
-        vtkCell* cell = input->GetCell(cellId);
+        input->GetCell(cellId, cell);
         int cellDim = cell->GetCellDimension();
         if (cellDim == 0)
         {
@@ -315,14 +438,11 @@ void vtkIntegrateAttributes::ExecuteBlock(vtkDataSet* input, vtkUnstructuredGrid
     }
   }
   cellPtIds->Delete();
+  cell->Delete();
   if (cellPoints)
   {
     cellPoints->Delete();
   }
-
-  this->PointFieldList = NULL;
-  this->CellFieldList = NULL;
-  this->FieldListIndex = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -506,35 +626,9 @@ int vtkIntegrateAttributes::RequestData(
   }
   sumArray->Delete();
 
-  int globalMin = this->PieceNodeMinToNode0(output);
-  int processId = this->Controller->GetLocalProcessId();
-  int numProcs = this->Controller->GetNumberOfProcesses();
-  if (globalMin == numProcs)
-  {
-    // there is no data in any of the processors
-    if (this->Sum != 0.0 && this->DivideAllCellDataByVolume)
-    {
-      DivideDataArraysByConstant(output->GetCellData(), true, this->Sum);
-    }
-    return 1;
-  }
-  if (processId > 0)
+  this->ReduceToNode0(output);
+  if (this->Controller->GetLocalProcessId() == 0)
   {
-    if (processId != globalMin)
-    {
-      this->SendPiece(output);
-    }
-  }
-  else
-  {
-    for (int id = 1; id < numProcs; ++id)
-    {
-      if (id != globalMin)
-      {
-        this->ReceivePiece(output, id);
-      }
-    }
-
     // now that we have all of the sums from each process
     // set the point location with the global value
     if (this->Sum != 0.0)
@@ -559,63 +653,145 @@ int vtkIntegrateAttributes::RequestData(
   return 1;
 }
 
-int vtkIntegrateAttributes::PieceNodeMinToNode0(vtkUnstructuredGrid* data)
+//-----------------------------------------------------------------------------
+void vtkIntegrateAttributes::ReduceToNode0(vtkUnstructuredGrid* data)
 {
   int numProcs = this->Controller->GetNumberOfProcesses();
   int processId = this->Controller->GetLocalProcessId();
-  int localMin = (data->GetNumberOfCells() == 0 ? numProcs : processId);
-  int globalMin = numProcs;
   if (numProcs == 1)
   {
-    return 0;
+    return;
+  }
+
+  // The highest integration dimension prevails, and the arrays reduced are the
+  // ones of the lowest process that integrated it and has arrays. Every
+  // process has a vertex at this point, so an empty piece is recognized by its
+  // lack of arrays. Both are found in a single call by minimizing
+  // (3 - dimension) * (numProcs + 1) + process.
+  vtkDataSetAttributes* attributes[2] = { data->GetPointData(), data->GetCellData() };
+  bool hasArrays =
+    attributes[0]->GetNumberOfArrays() > 0 || attributes[1]->GetNumberOfArrays() > 0;
+  int local = (3 - this->IntegrationDimension) * (numProcs + 1) +
+    (hasArrays ? processId : numProcs);
+  int global;
+  this->Controller->AllReduce(&local, &global, 1, vtkCommunicator::MIN_OP);
+  int dimension = 3 - global / (numProcs + 1);
+  int layoutId = global % (numProcs + 1);
+
+  // Names and number of components of the arrays to reduce.
+  vtkMultiProcessStream layout;
+  if (layoutId == numProcs)
+  {
+    // No process that integrated the highest dimension has arrays.
+    layout << 0 << 0;
   }
-  this->Controller->AllReduce(&localMin, &globalMin, 1, vtkCommunicator::MIN_OP);
-  if (globalMin == 0 || globalMin == numProcs)
+  else
   {
-    return globalMin;
+    if (processId == layoutId)
+    {
+      for (int cc = 0; cc < 2; ++cc)
+      {
+        layout << attributes[cc]->GetNumberOfArrays();
+        for (int i = 0; i < attributes[cc]->GetNumberOfArrays(); ++i)
+        {
+          vtkDataArray* array = attributes[cc]->GetArray(i);
+          layout << std::string(array->GetName() ? array->GetName() : "")
+                 << array->GetNumberOfComponents();
+        }
+      }
+    }
+    this->Controller->Broadcast(layout, layoutId);
   }
-  if (processId == 0)
+
+  std::vector<std::string> names[2];
+  std::vector<int> components[2];
+  int numValues = 4;
+  for (int cc = 0; cc < 2; ++cc)
   {
-    this->ReceivePiece(data, globalMin);
+    int numArrays;
+    layout >> numArrays;
+    names[cc].resize(numArrays);
+    components[cc].resize(numArrays);
+    for (int i = 0; i < numArrays; ++i)
+    {
+      layout >> names[cc][i] >> components[cc][i];
+      numValues += components[cc][i];
+    }
   }
-  else if (processId == globalMin)
+
+  // Pack the sums of this process. Processes that integrated a lower dimension
+  // contribute nothing. Arrays are matched by name, as they may be in a
+  // different order, except on the process that defined them.
+  std::vector<double> values(numValues, 0.0);
+  if (this->IntegrationDimension == dimension)
   {
-    this->SendPiece(data);
+    values[0] = this->Sum;
+    values[1] = this->SumCenter[0];
+    values[2] = this->SumCenter[1];
+    values[3] = this->SumCenter[2];
+    int offset = 4;
+    for (int cc = 0; cc < 2; ++cc)
+    {
+      for (size_t i = 0; i < names[cc].size(); ++i)
+      {
+        vtkDataArray* array = NULL;
+        if (processId == layoutId)
+        {
+          array = attributes[cc]->GetArray(static_cast<int>(i));
+        }
+        else if (!names[cc][i].empty())
+        {
+          array = attributes[cc]->GetArray(names[cc][i].c_str());
+        }
+        if (array && array->GetNumberOfComponents() == components[cc][i])
+        {
+          for (int j = 0; j < components[cc][i]; ++j)
+          {
+            values[offset + j] = array->GetComponent(0, j);
+          }
+        }
+        offset += components[cc][i];
+      }
+    }
   }
-  return globalMin;
-}
 
-void vtkIntegrateAttributes::SendPiece(vtkUnstructuredGrid* src)
-{
-  double msg[5];
-  msg[0] = (double)(this->IntegrationDimension);
-  msg[1] = this->Sum;
-  msg[2] = this->SumCenter[0];
-  msg[3] = this->SumCenter[1];
-  msg[4] = this->SumCenter[2];
-  this->Controller->Send(msg, 5, 0, vtkIntegrateAttributes::IntegrateAttrInfo);
-  this->Controller->Send(src, 0, vtkIntegrateAttributes::IntegrateAttrData);
-  // Done sending.  Reset src so satellites will have empty data.
-  src->Initialize();
-}
+  std::vector<double> sums(numValues, 0.0);
+  this->Controller->Reduce(&values[0], &sums[0], numValues, vtkCommunicator::SUM_OP, 0);
 
-void vtkIntegrateAttributes::ReceivePiece(vtkUnstructuredGrid* mergeTo, int fromId)
-{
-  double msg[5];
-  this->Controller->Receive(msg, 5, fromId, vtkIntegrateAttributes::IntegrateAttrInfo);
-  vtkUnstructuredGrid* tmp = vtkUnstructuredGrid::New();
-  this->Controller->Receive(tmp, fromId, vtkIntegrateAttributes::IntegrateAttrData);
-  if (this->CompareIntegrationDimension(mergeTo, (int)(msg[0])))
+  if (processId != 0)
+  {
+    // Satellites have empty data.
+    data->Initialize();
+    return;
+  }
+
+  this->IntegrationDimension = dimension;
+  this->Sum = sums[0];
+  this->SumCenter[0] = sums[1];
+  this->SumCenter[1] = sums[2];
+  this->SumCenter[2] = sums[3];
+  int offset = 4;
+  for (int cc = 0; cc < 2; ++cc)
   {
-    this->Sum += msg[1];
-    this->SumCenter[0] += msg[2];
-    this->SumCenter[1] += msg[3];
-    this->SumCenter[2] += msg[4];
-    this->IntegrateSatelliteData(tmp->GetPointData(), mergeTo->GetPointData());
-    this->IntegrateSatelliteData(tmp->GetCellData(), mergeTo->GetCellData());
+    attributes[cc]->Initialize();
+    for (size_t i = 0; i < names[cc].size(); ++i)
+    {
+      vtkDoubleArray* array = vtkDoubleArray::New();
+      array->SetNumberOfComponents(components[cc][i]);
+      array->SetNumberOfTuples(1);
+      if (!names[cc][i].empty())
+      {
+        array->SetName(names[cc][i].c_str());
+      }
+      for (int j = 0; j < components[cc][i]; ++j)
+      {
+        array->SetComponent(0, j, sums[offset + j]);
+      }
+      offset += components[cc][i];
+      attributes[cc]->AddArray(array);
+      array->Delete();
+    }
   }
-  tmp->Delete();
-  tmp = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -100,9 +100,14 @@ protected:
     vtkDataSet* input, vtkUnstructuredGrid* output, vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateSatelliteData(vtkDataSetAttributes* inda, vtkDataSetAttributes* outda);
   void ZeroAttributes(vtkDataSetAttributes* outda);
-  int PieceNodeMinToNode0(vtkUnstructuredGrid* data);
-  void SendPiece(vtkUnstructuredGrid* src);
-  void ReceivePiece(vtkUnstructuredGrid* mergeTo, int fromId);
+
+  /**
+   * Sums the integration results of all processes into process 0 with a
+   * single reduction. The arrays reduced are those of the lowest process with
+   * arrays among the ones that integrated the highest dimension, so that empty
+   * pieces do not drop them. Satellites are left with empty data.
+   */
+  void ReduceToNode0(vtkUnstructuredGrid* data);
 
   // This function assumes the data is in the format of the output of this filter with one
   // point/cell having the value computed as its only tuple.  It divides each value by sum,
@@ -116,6 +121,7 @@ private:
   void operator=(const vtkIntegrateAttributes&) = delete;
 
   class vtkFieldList;
+  class vtkIntegrateCellsFunctor;
   vtkFieldList* CellFieldList;
   vtkFieldList* PointFieldList;
   int FieldListIndex;
@@ -123,6 +129,8 @@ private:
   void AllocateAttributes(vtkFieldList& fieldList, vtkDataSetAttributes* outda);
   void ExecuteBlock(vtkDataSet* input, vtkUnstructuredGrid* output, int fieldset_index,
     vtkFieldList& pdList, vtkFieldList& cdList);
+  void IntegrateCells(
+    vtkDataSet* input, vtkUnstructuredGrid* output, vtkIdType begin, vtkIdType end);
 
   void IntegrateData1(vtkDataSetAttributes* inda, vtkDataSetAttributes* outda, vtkIdType pt1Id,
     double k, vtkFieldList& fieldlist, int fieldlist_index);
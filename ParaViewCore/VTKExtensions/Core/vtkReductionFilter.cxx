@@ -40,7 +40,7 @@
 #include "vtkToolkits.h"
 #include "vtkTrivialProducer.h"
 
-#include <sstream>
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -60,6 +60,7 @@ vtkReductionFilter::vtkReductionFilter()
   this->GenerateProcessIds = 0;
   this->ReductionMode = vtkReductionFilter::REDUCE_ALL_TO_ONE;
   this->ReductionProcessId = 0;
+  this->TreeFanIn = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -366,6 +367,12 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     }
   }
 
+  if (this->CanUseTreeReduction())
+  {
+    this->TreeReduce(preOutput, output);
+    return;
+  }
+
   std::vector<vtkSmartPointer<vtkDataObject> > data_sets;
   std::vector<vtkSmartPointer<vtkDataObject> > receiveData(numProcs);
 
@@ -435,6 +442,137 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     this->PostProcess(output, &data_sets[0], static_cast<unsigned int>(data_sets.size()));
   }
 }
+
+//-----------------------------------------------------------------------------
+bool vtkReductionFilter::CanUseTreeReduction()
+{
+  if (this->TreeFanIn < 2 || this->PostGatherHelper == NULL || this->PassThrough >= 0 ||
+    this->ReductionMode == vtkReductionFilter::REDUCE_ALL_TO_ALL)
+  {
+    return false;
+  }
+
+  // selections are not transferred with the regular data object
+  // communication, and the type of the pre-gather output may differ between
+  // processes when the helper accepts any data object. Since this decision
+  // must be the same on all processes, base it on the helper's input type.
+  vtkInformation* info = this->PostGatherHelper->GetInputPortInformation(0);
+  const char* expectedType = info ? info->Get(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE()) : NULL;
+  return expectedType != NULL && strcmp(expectedType, "vtkDataObject") != 0 &&
+    strcmp(expectedType, "vtkSelection") != 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkReductionFilter::TreeReduce(vtkDataObject* preOutput, vtkDataObject* output)
+{
+  vtkMultiProcessController* controller = this->Controller;
+  const int numProcs = controller->GetNumberOfProcesses();
+  const int myId = controller->GetLocalProcessId();
+  const int root = this->ReductionProcessId;
+  const int fanIn = this->TreeFanIn;
+
+  // The tree is rooted at process 0 so that subtrees cover contiguous ranges
+  // of process ids and the inputs reach the helper in process order, as with
+  // the flat gather. Each node owns a range [lo, hi); the remainder of the
+  // range after the node itself is split into at most fanIn chunks whose
+  // first ranks are the node's children. Walk down from process 0 to find
+  // this process' parent and range.
+  int lo = 0;
+  int hi = numProcs;
+  int parent = -1;
+  while (lo != myId)
+  {
+    const int chunk = (hi - lo - 1 + fanIn - 1) / fanIn;
+    const int child = lo + 1 + ((myId - lo - 1) / chunk) * chunk;
+    parent = lo;
+    lo = child;
+    hi = std::min(child + chunk, hi);
+  }
+
+  std::vector<vtkSmartPointer<vtkDataObject> > partials;
+  if (preOutput)
+  {
+    partials.push_back(preOutput);
+  }
+
+  // Receive the partial result of each child subtree. Children reduce their
+  // own subtrees independently and forward as soon as they are done, so the
+  // transfers at one level overlap with the merges at the levels below.
+  const int chunk = (hi - lo - 1 + fanIn - 1) / fanIn;
+  for (int child = lo + 1; child < hi; child += chunk)
+  {
+    vtkSmartPointer<vtkDataObject> data = this->ReceivePartial(child);
+    if (data)
+    {
+      partials.push_back(data);
+    }
+  }
+
+  if (parent < 0 && root == 0)
+  {
+    if (partials.size() > 0)
+    {
+      this->PostProcess(output, &partials[0], static_cast<unsigned int>(partials.size()));
+    }
+    return;
+  }
+
+  // Merge the partial results of this subtree, if there is more than one,
+  // before forwarding them to the parent. When the reduction process is not
+  // 0, process 0 forwards the result of the whole tree to it.
+  vtkSmartPointer<vtkDataObject> merged;
+  if (partials.size() == 1)
+  {
+    merged = partials[0];
+  }
+  else if (partials.size() > 1)
+  {
+    merged.TakeReference(output->NewInstance());
+    this->PostProcess(merged, &partials[0], static_cast<unsigned int>(partials.size()));
+  }
+  this->SendPartial(merged, parent < 0 ? root : parent);
+
+  if (myId == root)
+  {
+    vtkSmartPointer<vtkDataObject> data = this->ReceivePartial(0);
+    if (data)
+    {
+      vtkSmartPointer<vtkDataObject> inputs[1] = { data };
+      this->PostProcess(output, inputs, 1);
+    }
+  }
+  else if (preOutput && this->ReductionMode == vtkReductionFilter::REDUCE_ALL_TO_ONE)
+  {
+    // Satellites keep their own reduced data, as with the flat gather.
+    vtkSmartPointer<vtkDataObject> inputs[1] = { preOutput };
+    this->PostProcess(output, inputs, 1);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkReductionFilter::SendPartial(vtkDataObject* data, int destProcessId)
+{
+  int hasData = data ? 1 : 0;
+  this->Controller->Send(&hasData, 1, destProcessId, TRANSMIT_DATA_OBJECT);
+  if (hasData)
+  {
+    this->Controller->Send(data, destProcessId, TRANSMIT_DATA_OBJECT);
+  }
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> vtkReductionFilter::ReceivePartial(int srcProcessId)
+{
+  vtkSmartPointer<vtkDataObject> data;
+  int hasData = 0;
+  this->Controller->Receive(&hasData, 1, srcProcessId, TRANSMIT_DATA_OBJECT);
+  if (hasData)
+  {
+    data.TakeReference(this->Controller->ReceiveDataObject(srcProcessId, TRANSMIT_DATA_OBJECT));
+  }
+  return data;
+}
+
 //----------------------------------------------------------------------------
 int vtkReductionFilter::GatherSelection(vtkSelection* sendData,
   std::vector<vtkSmartPointer<vtkDataObject> >& receiveData, int destProcessId)
@@ -485,4 +623,5 @@ void vtkReductionFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Controller: " << this->Controller << endl;
   os << indent << "PassThrough: " << this->PassThrough << endl;
   os << indent << "GenerateProcessIds: " << this->GenerateProcessIds << endl;
+  os << indent << "TreeFanIn: " << this->TreeFanIn << endl;
 }
@@ -124,6 +124,27 @@ public:
   vtkGetMacro(GenerateProcessIds, int);
   //@}
 
+  //@{
+  /**
+   * Get/Set the fan-in of the reduction tree. When set to 2 or more, data is
+   * not gathered directly on the reduction process. Instead, processes are
+   * arranged in a tree with at most TreeFanIn children per node, and each
+   * intermediate process runs the PostGatherHelper on the partial results of
+   * its subtree before forwarding them to its parent. The tree is rooted at
+   * process 0 and subtrees cover contiguous ranges of ranks, so inputs still
+   * reach the helper in process order; when ReductionProcessId is not 0,
+   * process 0 forwards the final result to it. This requires the
+   * PostGatherHelper to accept its own output as input, as is the case for
+   * append, merge-tables or attribute reductions.
+   * The tree is only used with REDUCE_ALL_TO_ONE and MOVE_ALL_TO_ONE, when a
+   * PostGatherHelper with a specific input type other than vtkSelection is
+   * set and PassThrough is negative; otherwise the flat gather is used.
+   * Default is 0 i.e. flat gather.
+   */
+  vtkSetMacro(TreeFanIn, int);
+  vtkGetMacro(TreeFanIn, int);
+  //@}
+
   enum Tags
   {
     TRANSMIT_DATA_OBJECT = 23484
@@ -155,6 +176,28 @@ protected:
   int GatherSelection(vtkSelection* sendData,
     std::vector<vtkSmartPointer<vtkDataObject> >& receiveData, int destProcessId);
 
+  /**
+   * Returns true if the current settings allow the reduction to be done
+   * along a tree (see SetTreeFanIn). The result only depends on state that is
+   * identical on all processes.
+   */
+  bool CanUseTreeReduction();
+
+  /**
+   * Reduce preOutput from all processes to ReductionProcessId along a
+   * TreeFanIn-ary tree, merging partial results on intermediate processes.
+   */
+  void TreeReduce(vtkDataObject* preOutput, vtkDataObject* output);
+
+  //@{
+  /**
+   * Send or receive a partial result of the tree reduction, which may be
+   * NULL.
+   */
+  void SendPartial(vtkDataObject* data, int destProcessId);
+  vtkSmartPointer<vtkDataObject> ReceivePartial(int srcProcessId);
+  //@}
+
   vtkAlgorithm* PreGatherHelper;
   vtkAlgorithm* PostGatherHelper;
   vtkMultiProcessController* Controller;
@@ -162,6 +205,7 @@ protected:
   int GenerateProcessIds;
   int ReductionMode;
   int ReductionProcessId;
+  int TreeFanIn;
 
 private:
   vtkReductionFilter(const vtkReductionFilter&) = delete;
@@ -0,0 +1,199 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestCleanUnstructuredGrid.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that vtkCleanUnstructuredGrid merges the same points with and
+// without ParallelMerge, for inputs with duplicate points, signed zeros and
+// nan coordinates.
+
+#include "vtkCellArray.h"
+#include "vtkCleanUnstructuredGrid.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+vtkSmartPointer<vtkUnstructuredGrid> Clean(vtkUnstructuredGrid* input, bool parallel)
+{
+  vtkNew<vtkCleanUnstructuredGrid> clean;
+  clean->SetInputData(input);
+  clean->SetParallelMerge(parallel);
+  clean->Update();
+  return clean->GetOutput();
+}
+
+// nan coordinates are equal to each other here, since the outputs must have
+// the same points.
+bool SameValue(double a, double b)
+{
+  if (vtkMath::IsNan(a) || vtkMath::IsNan(b))
+  {
+    return vtkMath::IsNan(a) && vtkMath::IsNan(b);
+  }
+  return a == b;
+}
+
+bool SameArray(vtkDataArray* expected, vtkDataArray* actual)
+{
+  if (!expected || !actual || expected->GetNumberOfTuples() != actual->GetNumberOfTuples() ||
+    expected->GetNumberOfComponents() != actual->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < expected->GetNumberOfTuples(); cc++)
+  {
+    for (int comp = 0; comp < expected->GetNumberOfComponents(); comp++)
+    {
+      if (!SameValue(expected->GetComponent(cc, comp), actual->GetComponent(cc, comp)))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool Compare(vtkUnstructuredGrid* input, const char* name)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> expected = Clean(input, false);
+  vtkSmartPointer<vtkUnstructuredGrid> actual = Clean(input, true);
+  if (expected->GetNumberOfPoints() != actual->GetNumberOfPoints() ||
+    expected->GetNumberOfCells() != actual->GetNumberOfCells())
+  {
+    cerr << "Cleaning " << name << " with ParallelMerge gives " << actual->GetNumberOfPoints()
+         << " points and " << actual->GetNumberOfCells() << " cells instead of "
+         << expected->GetNumberOfPoints() << " points and " << expected->GetNumberOfCells()
+         << " cells." << endl;
+    return false;
+  }
+  if (!SameArray(expected->GetPoints()->GetData(), actual->GetPoints()->GetData()))
+  {
+    cerr << "Points of " << name << " differ." << endl;
+    return false;
+  }
+  if (!SameArray(expected->GetPointData()->GetArray("Ids"),
+        actual->GetPointData()->GetArray("Ids")))
+  {
+    cerr << "Point data of " << name << " differ." << endl;
+    return false;
+  }
+  if (!SameArray(expected->GetCells()->GetData(), actual->GetCells()->GetData()) ||
+    !SameArray(expected->GetCellTypesArray(), actual->GetCellTypesArray()))
+  {
+    cerr << "Connectivity of " << name << " differs." << endl;
+    return false;
+  }
+  return true;
+}
+
+// Adds a vertex for every point and a triangle for every three consecutive
+// points, and an array holding the id of every point.
+void AddCells(vtkUnstructuredGrid* grid)
+{
+  vtkIdType numPts = grid->GetNumberOfPoints();
+  grid->Allocate(numPts + numPts / 3);
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("Ids");
+  for (vtkIdType cc = 0; cc < numPts; cc++)
+  {
+    grid->InsertNextCell(VTK_VERTEX, 1, &cc);
+    ids->InsertNextValue(cc);
+  }
+  for (vtkIdType cc = 0; cc + 2 < numPts; cc += 3)
+  {
+    vtkIdType triangle[3] = { cc, cc + 1, cc + 2 };
+    grid->InsertNextCell(VTK_TRIANGLE, 3, triangle);
+  }
+  grid->GetPointData()->AddArray(ids.GetPointer());
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> NewSpecialValuesInput()
+{
+  const double nan = vtkMath::Nan();
+  const double coordinates[][3] = { { 0, 0, 0 }, { 1, 2, 3 }, { -0.0, 0, 0 }, { 1, 2, 3 },
+    { 0, -0.0, -0.0 }, { nan, 0, 0 }, { nan, 0, 0 }, { 1, nan, 3 }, { 1, 2, nan }, { 1, 2, 3 },
+    { 1 + 1e-12, 2, 3 }, { 1 + 1e-3, 2, 3 }, { 0.1, 0.2, 0.3 }, { 0.1, 0.2, 0.3 },
+    { -1, -2, -3 }, { nan, nan, nan }, { -1, -2, -3 }, { 0, 0, -0.0 } };
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (size_t cc = 0; cc < sizeof(coordinates) / sizeof(coordinates[0]); cc++)
+  {
+    points->InsertNextPoint(coordinates[cc]);
+  }
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points.GetPointer());
+  AddCells(grid);
+  return grid;
+}
+
+// Points on a coarse lattice visited in a scrambled order, so that most of
+// them are duplicates, with a few nan and negative zero coordinates.
+vtkSmartPointer<vtkUnstructuredGrid> NewLatticeInput()
+{
+  const int numPts = 30000;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPts);
+  for (int cc = 0; cc < numPts; cc++)
+  {
+    int index = (cc * 7919) % 1000;
+    double pt[3] = { (index % 10) * 0.5, ((index / 10) % 10) * 0.25, (index / 100) * 0.125 };
+    if (cc % 997 == 0)
+    {
+      pt[cc % 3] = vtkMath::Nan();
+    }
+    else if (cc % 13 == 0)
+    {
+      pt[0] = pt[0] == 0.0 ? -0.0 : pt[0];
+    }
+    points->SetPoint(cc, pt);
+  }
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points.GetPointer());
+  AddCells(grid);
+  return grid;
+}
+}
+
+int TestCleanUnstructuredGrid(int, char* [])
+{
+  vtkSMPTools::Initialize();
+
+  vtkSmartPointer<vtkUnstructuredGrid> special = NewSpecialValuesInput();
+  if (!Compare(special, "special values"))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkSmartPointer<vtkUnstructuredGrid> cleaned = Clean(special, true);
+  if (cleaned->GetNumberOfPoints() != 10)
+  {
+    cerr << "Expected 10 points after cleaning special values, got "
+         << cleaned->GetNumberOfPoints() << endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!Compare(NewLatticeInput(), "lattice"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
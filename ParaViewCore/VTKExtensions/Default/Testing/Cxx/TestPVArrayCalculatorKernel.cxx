@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVArrayCalculatorKernel.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that vtkPVArrayCalculator gives the same results with and without
+// UseCompiledKernel for the operations and functions the kernel supports.
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkPVArrayCalculator.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace
+{
+const int NumberOfPoints = 1000;
+
+vtkSmartPointer<vtkPolyData> NewInput()
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> s;
+  s->SetName("s");
+  vtkNew<vtkDoubleArray> v;
+  v->SetName("v");
+  v->SetNumberOfComponents(3);
+  for (int i = 0; i < NumberOfPoints; i++)
+  {
+    points->InsertNextPoint(i * 0.01, sin(0.1 * i), cos(0.1 * i));
+    double value = 1.0 + i * 0.001;
+    s->InsertNextValue(value);
+    v->InsertNextTuple3(value, 2.0 - 0.1 * value, 0.5 + 0.002 * i);
+  }
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(points.GetPointer());
+  input->GetPointData()->AddArray(s.GetPointer());
+  input->GetPointData()->AddArray(v.GetPointer());
+  return input;
+}
+
+vtkSmartPointer<vtkPolyData> Evaluate(vtkPolyData* input, const char* function, bool useKernel,
+  bool resultNormals, bool replaceInvalid)
+{
+  vtkNew<vtkPVArrayCalculator> calculator;
+  calculator->SetInputData(input);
+  calculator->SetAttributeType(vtkDataObject::POINT);
+  calculator->SetResultArrayName("Result");
+  calculator->SetResultNormals(resultNormals);
+  calculator->SetFunction(function);
+  calculator->SetReplaceInvalidValues(replaceInvalid);
+  calculator->SetReplacementValue(-7.0);
+  calculator->SetUseCompiledKernel(useKernel);
+  calculator->Update();
+  return vtkPolyData::SafeDownCast(calculator->GetOutput());
+}
+
+bool SameName(vtkDataArray* expected, vtkDataArray* actual)
+{
+  if (!expected || !actual)
+  {
+    return expected == actual;
+  }
+  return std::string(expected->GetName()) == actual->GetName();
+}
+
+bool Compare(vtkPolyData* input, const char* function, bool resultNormals = false,
+  bool replaceInvalid = false)
+{
+  vtkSmartPointer<vtkPolyData> expected =
+    Evaluate(input, function, false, resultNormals, replaceInvalid);
+  vtkSmartPointer<vtkPolyData> actual =
+    Evaluate(input, function, true, resultNormals, replaceInvalid);
+  vtkDataArray* expectedResult = expected->GetPointData()->GetArray("Result");
+  vtkDataArray* actualResult = actual->GetPointData()->GetArray("Result");
+  if (!expectedResult || !actualResult ||
+    expectedResult->GetNumberOfTuples() != actualResult->GetNumberOfTuples() ||
+    expectedResult->GetNumberOfComponents() != actualResult->GetNumberOfComponents() ||
+    expectedResult->GetDataType() != actualResult->GetDataType())
+  {
+    cerr << "Result arrays of " << function << " differ." << endl;
+    return false;
+  }
+
+  if (!SameName(expected->GetPointData()->GetScalars(), actual->GetPointData()->GetScalars()) ||
+    !SameName(expected->GetPointData()->GetVectors(), actual->GetPointData()->GetVectors()) ||
+    !SameName(expected->GetPointData()->GetNormals(), actual->GetPointData()->GetNormals()))
+  {
+    cerr << "Active attributes of " << function << " differ." << endl;
+    return false;
+  }
+
+  for (vtkIdType cc = 0; cc < expectedResult->GetNumberOfTuples(); cc++)
+  {
+    for (int comp = 0; comp < expectedResult->GetNumberOfComponents(); comp++)
+    {
+      double a = expectedResult->GetComponent(cc, comp);
+      double b = actualResult->GetComponent(cc, comp);
+      if (fabs(a - b) > 1e-12 * std::max(1.0, fabs(a)))
+      {
+        cerr << "Value " << cc << ", " << comp << " of " << function << " differs: expected " << a
+             << ", got " << b << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int TestPVArrayCalculatorKernel(int, char* [])
+{
+  vtkSmartPointer<vtkPolyData> input = NewInput();
+
+  const char* functions[] = { "s + 2 * s - 3 / s", "-s * (s - 0.5)", "s^2", "s^-1.5", "2^s",
+    "sqrt(s)", "exp(s)", "ln(s)", "log(s)", "log10(s)", "sin(s)", "cos(s)", "tan(s)",
+    "asin(s / 10)", "acos(s / 10)", "atan(s)", "sinh(s)", "cosh(s)", "tanh(s)", "abs(1.5 - s)",
+    "ceil(10 * s)", "floor(10 * s)", "sign(s - 1.5)", "min(s, 1.5)", "max(s, 1.5)",
+    "coordsX + coordsY * coordsZ", "v_X - v_Z", "mag(v)", "norm(v)", "2 * v + coords",
+    "v / s", "v . coords", "cross(v, coords)", "mag(cross(v, coords)) * s" };
+  for (size_t cc = 0; cc < sizeof(functions) / sizeof(functions[0]); cc++)
+  {
+    if (!Compare(input, functions[cc]))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  if (!Compare(input, "norm(v)", true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Invalid operations whose result is the final value are replaced the same
+  // way.
+  const char* invalidFunctions[] = { "sqrt(s - 1.5)", "ln(s - 1.2)", "1 / (s - 1.5)",
+    "asin(2 * s - 2.5)", "v / (s - 1.5)", "s" };
+  for (size_t cc = 0; cc < sizeof(invalidFunctions) / sizeof(invalidFunctions[0]); cc++)
+  {
+    if (!Compare(input, invalidFunctions[cc], false, true))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -23,15 +23,133 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// A point, as the bits of its coordinates in single precision, which is the
+// precision vtkMergePoints compares points in.
+struct vtkMergeKey
+{
+  vtkTypeUInt32 Coordinates[3];
+  vtkIdType Id;
+
+  bool operator<(const vtkMergeKey& other) const
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      if (this->Coordinates[i] != other.Coordinates[i])
+      {
+        return this->Coordinates[i] < other.Coordinates[i];
+      }
+    }
+    return this->Id < other.Id;
+  }
+};
+
+vtkTypeUInt32 vtkFloatToBits(double value)
+{
+  float f = static_cast<float>(value);
+  if (f == 0.0f)
+  {
+    f = 0.0f; // -0 and 0 are the same coordinate.
+  }
+  vtkTypeUInt32 bits;
+  memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+// Keys with the same bits are coincident points, unless a coordinate is nan
+// (nan never compares equal, so such points are never merged).
+bool vtkSamePoint(const vtkMergeKey& a, const vtkMergeKey& b)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    float f;
+    memcpy(&f, &a.Coordinates[i], sizeof(f));
+    if (a.Coordinates[i] != b.Coordinates[i] || f != f)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+class vtkComputeMergeKeys
+{
+  vtkDataSet* Input;
+  vtkMergeKey* Keys;
+
+public:
+  vtkComputeMergeKeys(vtkDataSet* input, vtkMergeKey* keys)
+    : Input(input)
+    , Keys(keys)
+  {
+  }
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double pt[3];
+    for (vtkIdType id = begin; id < end; ++id)
+    {
+      this->Input->GetPoint(id, pt);
+      for (int i = 0; i < 3; ++i)
+      {
+        this->Keys[id].Coordinates[i] = vtkFloatToBits(pt[i]);
+      }
+      this->Keys[id].Id = id;
+    }
+  }
+};
+
+// Maps every point of a run of coincident points in the sorted keys to the
+// first point of the run, i.e. the one with the smallest id. Each run is
+// handled by the range its first key belongs to.
+class vtkFindRepresentatives
+{
+  const vtkMergeKey* Keys;
+  vtkIdType NumberOfKeys;
+  vtkIdType* Representatives;
+
+public:
+  vtkFindRepresentatives(const vtkMergeKey* keys, vtkIdType numKeys, vtkIdType* representatives)
+    : Keys(keys)
+    , NumberOfKeys(numKeys)
+    , Representatives(representatives)
+  {
+  }
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (i > 0 && vtkSamePoint(this->Keys[i - 1], this->Keys[i]))
+      {
+        continue;
+      }
+      vtkIdType representative = this->Keys[i].Id;
+      this->Representatives[representative] = representative;
+      for (vtkIdType j = i + 1;
+           j < this->NumberOfKeys && vtkSamePoint(this->Keys[i], this->Keys[j]); ++j)
+      {
+        this->Representatives[this->Keys[j].Id] = representative;
+      }
+    }
+  }
+};
+}
+
 vtkStandardNewMacro(vtkCleanUnstructuredGrid);
 
 //----------------------------------------------------------------------------
 vtkCleanUnstructuredGrid::vtkCleanUnstructuredGrid()
 {
   this->Locator = vtkMergePoints::New();
+  this->ParallelMerge = true;
 }
 
 //----------------------------------------------------------------------------
@@ -45,6 +163,66 @@ vtkCleanUnstructuredGrid::~vtkCleanUnstructuredGrid()
 void vtkCleanUnstructuredGrid::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ParallelMerge: " << this->ParallelMerge << endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkCleanUnstructuredGrid::MergePointsInParallel(
+  vtkDataSet* input, vtkUnstructuredGrid* output, vtkPoints* newPts, vtkIdType* ptMap)
+{
+  vtkIdType num = input->GetNumberOfPoints();
+  if (num == 0)
+  {
+    return;
+  }
+  std::vector<vtkMergeKey> keys(num);
+
+  // GetPoint() is only known to be thread safe for point sets.
+  vtkComputeMergeKeys computeKeys(input, &keys[0]);
+  if (vtkPointSet::SafeDownCast(input))
+  {
+    vtkSMPTools::For(0, num, computeKeys);
+  }
+  else
+  {
+    computeKeys(0, num);
+  }
+  this->UpdateProgress(0.1);
+
+  // Sorting makes coincident points adjacent, ordered by id. Since ids break
+  // ties, the order does not depend on the number of threads.
+  vtkSMPTools::Sort(keys.begin(), keys.end());
+  this->UpdateProgress(0.5);
+
+  // ptMap first holds the representative of each point.
+  vtkFindRepresentatives findRepresentatives(&keys[0], num, ptMap);
+  vtkSMPTools::For(0, num, findRepresentatives);
+  std::vector<vtkMergeKey>().swap(keys);
+  this->UpdateProgress(0.6);
+
+  // Number the representatives in increasing id order, which is the order
+  // vtkMergePoints would have inserted them in. A representative always has a
+  // smaller id than the points it represents, so those points are renumbered
+  // after it.
+  vtkPointData* inPD = input->GetPointData();
+  vtkPointData* outPD = output->GetPointData();
+  vtkIdType newId = 0;
+  double pt[3];
+  for (vtkIdType id = 0; id < num; ++id)
+  {
+    if (ptMap[id] == id)
+    {
+      input->GetPoint(id, pt);
+      newPts->InsertPoint(newId, pt);
+      outPD->CopyData(inPD, id, newId);
+      ptMap[id] = newId++;
+    }
+    else
+    {
+      ptMap[id] = ptMap[ptMap[id]];
+    }
+  }
+  this->UpdateProgress(0.8);
 }
 
 //----------------------------------------------------------------------------
@@ -83,25 +261,32 @@ int vtkCleanUnstructuredGrid::RequestData(vtkInformation* vtkNotUsed(request),
   vtkIdType* ptMap = new vtkIdType[num];
   double pt[3];
 
-  this->Locator->InitPointInsertion(newPts, input->GetBounds(), num);
-
   vtkIdType progressStep = num / 100;
   if (progressStep == 0)
   {
     progressStep = 1;
   }
-  for (id = 0; id < num; ++id)
+  if (this->ParallelMerge)
   {
-    if (id % progressStep == 0)
-    {
-      this->UpdateProgress(0.8 * ((float)id / num));
-    }
-    input->GetPoint(id, pt);
-    if (this->Locator->InsertUniquePoint(pt, newId))
+    this->MergePointsInParallel(input, output, newPts, ptMap);
+  }
+  else
+  {
+    this->Locator->InitPointInsertion(newPts, input->GetBounds(), num);
+
+    for (id = 0; id < num; ++id)
     {
-      output->GetPointData()->CopyData(input->GetPointData(), id, newId);
+      if (id % progressStep == 0)
+      {
+        this->UpdateProgress(0.8 * ((float)id / num));
+      }
+      input->GetPoint(id, pt);
+      if (this->Locator->InsertUniquePoint(pt, newId))
+      {
+        output->GetPointData()->CopyData(input->GetPointData(), id, newId);
+      }
+      ptMap[id] = newId;
     }
-    ptMap[id] = newId;
   }
   output->SetPoints(newPts);
   newPts->Delete();
@@ -23,6 +23,11 @@
  * merge duplicate points (with coincident coordinates) using the vtkMergePoints object
  * to merge points.
  *
+ * By default, points are merged in parallel using vtkSMPTools: they are
+ * sorted on their coordinates so that coincident points become adjacent. This
+ * produces the same points, in the same order, as inserting them one at a time
+ * in the vtkMergePoints locator, independently of the number of threads.
+ *
  * @sa
  * vtkCleanPolyData
 */
@@ -45,11 +50,30 @@ public:
 
   void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
 
+  //@{
+  /**
+   * When on (default), merge the points in parallel instead of inserting them
+   * one at a time in the Locator. Points are compared exactly, in single
+   * precision, as vtkMergePoints does.
+   */
+  vtkSetMacro(ParallelMerge, bool);
+  vtkGetMacro(ParallelMerge, bool);
+  vtkBooleanMacro(ParallelMerge, bool);
+  //@}
+
 protected:
   vtkCleanUnstructuredGrid();
   ~vtkCleanUnstructuredGrid() override;
 
+  /**
+   * Merge the points of the input in parallel. Fills the output points and
+   * point data, and ptMap with the output id of each input point.
+   */
+  void MergePointsInParallel(
+    vtkDataSet* input, vtkUnstructuredGrid* output, vtkPoints* newPts, vtkIdType* ptMap);
+
   vtkPointLocator* Locator;
+  bool ParallelMerge;
 
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) VTK_OVERRIDE;
   int FillInputPortInformation(int port, vtkInformation* info) VTK_OVERRIDE;
@@ -17,7 +17,167 @@
 #include <vtksys/SystemTools.hxx>
 
 #include <ctype.h>
+#include <fstream>
+#include <istream>
+#include <streambuf>
 #include <string>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Stream buffer over a read-only memory mapping of a file. The reader does
+// many seeks and small reads, which become pointer updates and memory copies
+// on a mapped file, and only the pages actually read are loaded. This is
+// notably the case when each process reads a subset of the file.
+class vtkMappedFileBuffer : public std::streambuf
+{
+public:
+  vtkMappedFileBuffer()
+    : Data(NULL)
+    , Size(0)
+  {
+  }
+  ~vtkMappedFileBuffer() override { this->Unmap(); }
+
+  bool Map(const char* filename, long size)
+  {
+    this->Unmap();
+#ifndef _WIN32
+    if (size <= 0)
+    {
+      return false;
+    }
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+      return false;
+    }
+    void* data = mmap(NULL, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid once the file descriptor is closed.
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+      return false;
+    }
+    this->Data = static_cast<char*>(data);
+    this->Size = static_cast<size_t>(size);
+    this->setg(this->Data, this->Data, this->Data + this->Size);
+    return true;
+#else
+    (void)filename;
+    (void)size;
+    return false;
+#endif
+  }
+
+  void Unmap()
+  {
+#ifndef _WIN32
+    if (this->Data)
+    {
+      munmap(this->Data, this->Size);
+    }
+#endif
+    this->Data = NULL;
+    this->Size = 0;
+    this->setg(NULL, NULL, NULL);
+  }
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+    std::ios_base::openmode which = std::ios_base::in) override
+  {
+    off_type base = 0;
+    if (dir == std::ios_base::cur)
+    {
+      base = this->gptr() - this->eback();
+    }
+    else if (dir == std::ios_base::end)
+    {
+      base = static_cast<off_type>(this->Size);
+    }
+    return this->seekpos(pos_type(base + off), which);
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in) override
+  {
+    off_type offset = pos;
+    if (!(which & std::ios_base::in) || offset < 0 ||
+      offset > static_cast<off_type>(this->Size))
+    {
+      return pos_type(off_type(-1));
+    }
+    this->setg(this->Data, this->Data + offset, this->Data + this->Size);
+    return pos;
+  }
+
+  std::streamsize xsgetn(char* s, std::streamsize n) override
+  {
+    std::streamsize available = this->egptr() - this->gptr();
+    std::streamsize count = n < available ? n : available;
+    if (count > 0)
+    {
+      memcpy(s, this->gptr(), static_cast<size_t>(count));
+      // gbump() takes an int, which is too small for large arrays.
+      this->setg(this->eback(), this->gptr() + count, this->egptr());
+    }
+    return count;
+  }
+
+private:
+  char* Data;
+  size_t Size;
+};
+}
+
+// Input stream on a memory mapped file, or on a regular file buffer when the
+// file cannot be mapped.
+class vtkPEnSightGoldBinaryReader::vtkFileStream : public std::istream
+{
+public:
+  vtkFileStream()
+    : std::istream(NULL)
+  {
+  }
+  ~vtkFileStream() override { this->close(); }
+
+  bool open(const char* filename, long size)
+  {
+    if (this->MappedBuffer.Map(filename, size))
+    {
+      this->rdbuf(&this->MappedBuffer);
+      return true;
+    }
+#ifdef _WIN32
+    std::ios_base::openmode mode = ios::in | ios::binary;
+#else
+    std::ios_base::openmode mode = ios::in;
+#endif
+    if (this->FileBuffer.open(filename, mode))
+    {
+      this->rdbuf(&this->FileBuffer);
+      return true;
+    }
+    this->setstate(std::ios_base::failbit);
+    return false;
+  }
+
+  void close()
+  {
+    this->MappedBuffer.Unmap();
+    this->FileBuffer.close();
+  }
+
+private:
+  vtkMappedFileBuffer MappedBuffer;
+  std::filebuf FileBuffer;
+};
 
 vtkStandardNewMacro(vtkPEnSightGoldBinaryReader);
 
@@ -84,11 +244,8 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
     // Find out how big the file is.
     this->FileSize = (long)(fs.st_size);
 
-#ifdef _WIN32
-    this->IFile = new ifstream(filename, ios::in | ios::binary);
-#else
-    this->IFile = new ifstream(filename, ios::in);
-#endif
+    this->IFile = new vtkFileStream;
+    this->IFile->open(filename, this->FileSize);
   }
   else
   {
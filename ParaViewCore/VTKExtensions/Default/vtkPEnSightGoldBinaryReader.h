@@ -205,7 +205,9 @@ protected:
   int ElementIdsListed;
   int Fortran;
 
-  ifstream* IFile;
+  // Input stream reading the file through a memory mapping when possible.
+  class vtkFileStream;
+  vtkFileStream* IFile;
   // The size of the file could be used to choose byte order.
   long FileSize;
 
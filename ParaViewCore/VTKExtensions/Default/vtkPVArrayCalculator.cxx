@@ -15,6 +15,7 @@
 #include "vtkPVArrayCalculator.h"
 
 #include "vtkCellData.h"
+#include "vtkDataArray.h"
 #include "vtkDataObject.h"
 #include "vtkDataSet.h"
 #include "vtkFunctionParser.h"
@@ -24,13 +25,25 @@
 #include "vtkObjectFactory.h"
 #include "vtkPVPostFilter.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTable.h"
 
 #include <algorithm>
 #include <assert.h>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
 #include <set>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace
 {
@@ -67,17 +80,841 @@ public:
     this->Calc->AddScalarVariable(name.c_str(), this->ArrayName, this->Component);
   }
 };
+
+//----------------------------------------------------------------------------
+// Variables registered with the superclass, as recorded by
+// UpdateArrayAndVariableNames(). An empty ArrayName stands for the point
+// coordinates.
+struct vtkCalculatorVariable
+{
+  std::string ArrayName;
+  int NumberOfComponents;
+  int Components[3];
+};
+typedef std::map<std::string, vtkCalculatorVariable> vtkCalculatorVariables;
+
+void vtkAddCalculatorVariable(vtkCalculatorVariables& variables, const std::string& name,
+  const char* arrayName, int c0, int c1 = -1, int c2 = -1)
+{
+  vtkCalculatorVariable variable;
+  variable.ArrayName = arrayName ? arrayName : "";
+  variable.NumberOfComponents = c1 < 0 ? 1 : 3;
+  variable.Components[0] = c0;
+  variable.Components[1] = c1;
+  variable.Components[2] = c2;
+  // like the function parser, the first variable registered with a name wins.
+  variables.insert(vtkCalculatorVariables::value_type(name, variable));
 }
 
+//----------------------------------------------------------------------------
+// Compiled kernel.
+//
+// The function is translated into a program of scalar instructions, vector
+// operations being expanded per component. Every instruction writes a new
+// register, and a register holds the values of a block of tuples, so that
+// each instruction is a simple loop over the block that the compiler can
+// vectorize. Blocks are processed in parallel with vtkSMPTools.
+enum vtkKernelOpCode
+{
+  KERNEL_LOAD,
+  KERNEL_CONSTANT,
+  KERNEL_NEGATE,
+  KERNEL_ADD,
+  KERNEL_SUBTRACT,
+  KERNEL_MULTIPLY,
+  KERNEL_DIVIDE,
+  KERNEL_POWER,
+  KERNEL_MIN,
+  KERNEL_MAX,
+  KERNEL_ABS,
+  KERNEL_EXP,
+  KERNEL_CEIL,
+  KERNEL_FLOOR,
+  KERNEL_LN,
+  KERNEL_LOG10,
+  KERNEL_SQRT,
+  KERNEL_SIN,
+  KERNEL_COS,
+  KERNEL_TAN,
+  KERNEL_ASIN,
+  KERNEL_ACOS,
+  KERNEL_ATAN,
+  KERNEL_SINH,
+  KERNEL_COSH,
+  KERNEL_TANH,
+  KERNEL_SIGN,
+  // not instructions, expanded by the compiler.
+  KERNEL_MAG,
+  KERNEL_NORM,
+  KERNEL_CROSS
+};
+
+const vtkIdType vtkKernelBlockSize = 512;
+
+struct vtkKernelInstruction
+{
+  int OpCode;
+  int Result;
+  int Arg0;
+  int Arg1;
+  double Value;  // KERNEL_CONSTANT
+  int Input;     // KERNEL_LOAD
+  int Component; // KERNEL_LOAD
+};
+
+struct vtkKernelInput
+{
+  vtkDataArray* Array;
+  // used for the coordinates of datasets without explicit points.
+  vtkDataSet* DataSet;
+  // raw memory of Array, if it uses the standard memory layout.
+  void* Data;
+};
+
+struct vtkKernelValue
+{
+  int NumberOfComponents;
+  int Registers[3];
+};
+
+struct vtkKernelProgram
+{
+  vtkKernelProgram()
+    : NumberOfRegisters(0)
+  {
+  }
+  std::vector<vtkKernelInstruction> Instructions;
+  std::vector<vtkKernelInput> Inputs;
+  int NumberOfRegisters;
+  vtkKernelValue Result;
+};
+
+//----------------------------------------------------------------------------
+// Recursive descent parser for the function parser syntax, emitting a
+// vtkKernelProgram. Anything it does not understand makes Compile() fail, in
+// which case the function parser is used instead.
+class vtkKernelCompiler
+{
+public:
+  vtkKernelCompiler(const vtkCalculatorVariables& variables, vtkDataSetAttributes* attributes,
+    vtkDataSet* coordinates, vtkKernelProgram& program)
+    : Variables(variables)
+    , Attributes(attributes)
+    , Coordinates(coordinates)
+    , Program(program)
+    , Position(NULL)
+  {
+  }
+
+  bool Compile(const char* function)
+  {
+    this->Position = function;
+    vtkKernelValue result;
+    if (!this->ParseExpression(result) || this->Peek() != '\0')
+    {
+      return false;
+    }
+    this->Program.Result = result;
+    return true;
+  }
+
+private:
+  char Peek()
+  {
+    while (*this->Position && isspace(static_cast<unsigned char>(*this->Position)))
+    {
+      ++this->Position;
+    }
+    return *this->Position;
+  }
+
+  // expression: term (('+' | '-') term)*
+  bool ParseExpression(vtkKernelValue& value)
+  {
+    if (!this->ParseTerm(value))
+    {
+      return false;
+    }
+    for (char op = this->Peek(); op == '+' || op == '-'; op = this->Peek())
+    {
+      ++this->Position;
+      vtkKernelValue rhs;
+      if (!this->ParseTerm(rhs) || rhs.NumberOfComponents != value.NumberOfComponents)
+      {
+        return false;
+      }
+      value = this->EmitBinary(op == '+' ? KERNEL_ADD : KERNEL_SUBTRACT, value, rhs);
+    }
+    return true;
+  }
+
+  // term: unary (('*' | '/' | '.') unary)*
+  bool ParseTerm(vtkKernelValue& value)
+  {
+    if (!this->ParseUnary(value))
+    {
+      return false;
+    }
+    for (char op = this->Peek(); op == '*' || op == '/' || op == '.'; op = this->Peek())
+    {
+      ++this->Position;
+      vtkKernelValue rhs;
+      if (!this->ParseUnary(rhs))
+      {
+        return false;
+      }
+      if (op == '.')
+      {
+        if (value.NumberOfComponents != 3 || rhs.NumberOfComponents != 3)
+        {
+          return false;
+        }
+        value = this->EmitDot(value, rhs);
+      }
+      else if (op == '*')
+      {
+        if (value.NumberOfComponents == 3 && rhs.NumberOfComponents == 3)
+        {
+          return false;
+        }
+        value = this->EmitBinary(KERNEL_MULTIPLY, value, rhs);
+      }
+      else
+      {
+        if (rhs.NumberOfComponents != 1)
+        {
+          return false;
+        }
+        value = this->EmitBinary(KERNEL_DIVIDE, value, rhs);
+      }
+    }
+    return true;
+  }
+
+  // unary: '-' unary | power
+  bool ParseUnary(vtkKernelValue& value)
+  {
+    if (this->Peek() == '-')
+    {
+      ++this->Position;
+      if (!this->ParseUnary(value))
+      {
+        return false;
+      }
+      value = this->EmitUnary(KERNEL_NEGATE, value);
+      return true;
+    }
+    return this->ParsePower(value);
+  }
+
+  // power: primary ('^' '-'* primary)?
+  // Chained powers are left to the function parser.
+  bool ParsePower(vtkKernelValue& value)
+  {
+    if (!this->ParsePrimary(value))
+    {
+      return false;
+    }
+    if (this->Peek() != '^')
+    {
+      return true;
+    }
+    ++this->Position;
+    bool negate = false;
+    while (this->Peek() == '-')
+    {
+      ++this->Position;
+      negate = !negate;
+    }
+    vtkKernelValue exponent;
+    if (!this->ParsePrimary(exponent) || value.NumberOfComponents != 1 ||
+      exponent.NumberOfComponents != 1)
+    {
+      return false;
+    }
+    if (negate)
+    {
+      exponent = this->EmitUnary(KERNEL_NEGATE, exponent);
+    }
+    value = this->EmitBinary(KERNEL_POWER, value, exponent);
+    return this->Peek() != '^';
+  }
+
+  bool ParsePrimary(vtkKernelValue& value)
+  {
+    this->Peek();
+    const char* p = this->Position;
+    if (isdigit(static_cast<unsigned char>(*p)) ||
+      (*p == '.' && isdigit(static_cast<unsigned char>(p[1]))))
+    {
+      char* end = NULL;
+      double number = strtod(p, &end);
+      this->Position = end;
+      value = this->EmitConstant(number);
+      return true;
+    }
+    if (*p == '(')
+    {
+      ++this->Position;
+      if (!this->ParseExpression(value) || this->Peek() != ')')
+      {
+        return false;
+      }
+      ++this->Position;
+      return true;
+    }
+    int function = this->MatchFunction();
+    if (function >= 0)
+    {
+      return this->ParseFunction(function, value);
+    }
+    return this->ParseVariable(value);
+  }
+
+  // Returns the opcode of the function at the current position, if followed
+  // by a parenthesis, and moves past the parenthesis.
+  int MatchFunction()
+  {
+    static const struct
+    {
+      const char* Name;
+      int OpCode;
+    } functions[] = { { "abs", KERNEL_ABS }, { "exp", KERNEL_EXP }, { "ceil", KERNEL_CEIL },
+      { "floor", KERNEL_FLOOR }, { "ln", KERNEL_LN }, { "log10", KERNEL_LOG10 },
+      { "log", KERNEL_LN }, { "sqrt", KERNEL_SQRT }, { "sin", KERNEL_SIN },
+      { "cos", KERNEL_COS }, { "tan", KERNEL_TAN }, { "asin", KERNEL_ASIN },
+      { "acos", KERNEL_ACOS }, { "atan", KERNEL_ATAN }, { "sinh", KERNEL_SINH },
+      { "cosh", KERNEL_COSH }, { "tanh", KERNEL_TANH }, { "sign", KERNEL_SIGN },
+      { "min", KERNEL_MIN }, { "max", KERNEL_MAX }, { "mag", KERNEL_MAG },
+      { "norm", KERNEL_NORM }, { "cross", KERNEL_CROSS } };
+
+    for (size_t cc = 0; cc < sizeof(functions) / sizeof(functions[0]); ++cc)
+    {
+      size_t length = strlen(functions[cc].Name);
+      if (strncmp(this->Position, functions[cc].Name, length) == 0)
+      {
+        const char* next = this->Position + length;
+        while (*next && isspace(static_cast<unsigned char>(*next)))
+        {
+          ++next;
+        }
+        if (*next == '(')
+        {
+          this->Position = next + 1;
+          return functions[cc].OpCode;
+        }
+      }
+    }
+    return -1;
+  }
+
+  bool ParseFunction(int function, vtkKernelValue& value)
+  {
+    std::vector<vtkKernelValue> args;
+    if (this->Peek() != ')')
+    {
+      for (;;)
+      {
+        vtkKernelValue arg;
+        if (!this->ParseExpression(arg))
+        {
+          return false;
+        }
+        args.push_back(arg);
+        if (this->Peek() != ',')
+        {
+          break;
+        }
+        ++this->Position;
+      }
+    }
+    if (this->Peek() != ')')
+    {
+      return false;
+    }
+    ++this->Position;
+
+    switch (function)
+    {
+      case KERNEL_MIN:
+      case KERNEL_MAX:
+        if (args.size() != 2 || args[0].NumberOfComponents != 1 ||
+          args[1].NumberOfComponents != 1)
+        {
+          return false;
+        }
+        value = this->EmitBinary(function, args[0], args[1]);
+        return true;
+
+      case KERNEL_MAG:
+      case KERNEL_NORM:
+        if (args.size() != 1 || args[0].NumberOfComponents != 3)
+        {
+          return false;
+        }
+        value = this->EmitUnary(KERNEL_SQRT, this->EmitDot(args[0], args[0]));
+        if (function == KERNEL_NORM)
+        {
+          value = this->EmitBinary(KERNEL_DIVIDE, args[0], value);
+        }
+        return true;
+
+      case KERNEL_CROSS:
+        if (args.size() != 2 || args[0].NumberOfComponents != 3 ||
+          args[1].NumberOfComponents != 3)
+        {
+          return false;
+        }
+        value = this->EmitCross(args[0], args[1]);
+        return true;
+
+      default:
+        if (args.size() != 1 || args[0].NumberOfComponents != 1)
+        {
+          return false;
+        }
+        value = this->EmitUnary(function, args[0]);
+        return true;
+    }
+  }
+
+  // Variables are matched on the longest name, as the function parser does.
+  bool ParseVariable(vtkKernelValue& value)
+  {
+    static const char* const unitVectors[] = { "iHat", "jHat", "kHat" };
+
+    size_t bestLength = 0;
+    const vtkCalculatorVariable* best = NULL;
+    int unitVector = -1;
+    for (vtkCalculatorVariables::const_iterator iter = this->Variables.begin();
+         iter != this->Variables.end(); ++iter)
+    {
+      size_t length = iter->first.size();
+      if (length > bestLength && strncmp(this->Position, iter->first.c_str(), length) == 0)
+      {
+        bestLength = length;
+        best = &iter->second;
+      }
+    }
+    for (int cc = 0; cc < 3; ++cc)
+    {
+      size_t length = strlen(unitVectors[cc]);
+      if (length > bestLength && strncmp(this->Position, unitVectors[cc], length) == 0)
+      {
+        bestLength = length;
+        best = NULL;
+        unitVector = cc;
+      }
+    }
+    if (bestLength == 0)
+    {
+      return false;
+    }
+    this->Position += bestLength;
+
+    if (!best)
+    {
+      value.NumberOfComponents = 3;
+      for (int cc = 0; cc < 3; ++cc)
+      {
+        value.Registers[cc] = this->EmitConstant(cc == unitVector ? 1.0 : 0.0).Registers[0];
+      }
+      return true;
+    }
+
+    int input = this->GetInput(*best);
+    if (input < 0)
+    {
+      return false;
+    }
+    value.NumberOfComponents = best->NumberOfComponents;
+    for (int cc = 0; cc < best->NumberOfComponents; ++cc)
+    {
+      std::pair<int, int> key(input, best->Components[cc]);
+      std::map<std::pair<int, int>, int>::iterator loaded = this->Loaded.find(key);
+      if (loaded == this->Loaded.end())
+      {
+        vtkKernelInstruction instruction = this->NewInstruction(KERNEL_LOAD, -1, -1);
+        instruction.Input = input;
+        instruction.Component = best->Components[cc];
+        loaded = this->Loaded.insert(std::make_pair(key, this->Push(instruction))).first;
+      }
+      value.Registers[cc] = loaded->second;
+    }
+    return true;
+  }
+
+  int GetInput(const vtkCalculatorVariable& variable)
+  {
+    vtkKernelInput input;
+    input.Array = NULL;
+    input.DataSet = NULL;
+    input.Data = NULL;
+    int numberOfComponents = 3;
+    if (variable.ArrayName.empty())
+    {
+      if (!this->Coordinates)
+      {
+        return -1;
+      }
+      vtkPointSet* pointSet = vtkPointSet::SafeDownCast(this->Coordinates);
+      if (pointSet && pointSet->GetPoints())
+      {
+        input.Array = pointSet->GetPoints()->GetData();
+      }
+      else
+      {
+        input.DataSet = this->Coordinates;
+      }
+    }
+    else
+    {
+      input.Array = this->Attributes->GetArray(variable.ArrayName.c_str());
+      if (!input.Array)
+      {
+        return -1;
+      }
+      numberOfComponents = input.Array->GetNumberOfComponents();
+    }
+    for (int cc = 0; cc < variable.NumberOfComponents; ++cc)
+    {
+      if (variable.Components[cc] < 0 || variable.Components[cc] >= numberOfComponents)
+      {
+        return -1;
+      }
+    }
+
+    for (size_t cc = 0; cc < this->Program.Inputs.size(); ++cc)
+    {
+      if (this->Program.Inputs[cc].Array == input.Array &&
+        this->Program.Inputs[cc].DataSet == input.DataSet)
+      {
+        return static_cast<int>(cc);
+      }
+    }
+    if (input.Array && input.Array->HasStandardMemoryLayout() &&
+      input.Array->GetDataType() != VTK_BIT)
+    {
+      input.Data = input.Array->GetVoidPointer(0);
+    }
+    this->Program.Inputs.push_back(input);
+    return static_cast<int>(this->Program.Inputs.size()) - 1;
+  }
+
+  vtkKernelInstruction NewInstruction(int opCode, int arg0, int arg1)
+  {
+    vtkKernelInstruction instruction;
+    instruction.OpCode = opCode;
+    instruction.Result = -1;
+    instruction.Arg0 = arg0;
+    instruction.Arg1 = arg1;
+    instruction.Value = 0.0;
+    instruction.Input = -1;
+    instruction.Component = -1;
+    return instruction;
+  }
+
+  int Push(vtkKernelInstruction& instruction)
+  {
+    instruction.Result = this->Program.NumberOfRegisters++;
+    this->Program.Instructions.push_back(instruction);
+    return instruction.Result;
+  }
+
+  vtkKernelValue EmitConstant(double number)
+  {
+    vtkKernelInstruction instruction = this->NewInstruction(KERNEL_CONSTANT, -1, -1);
+    instruction.Value = number;
+    vtkKernelValue value;
+    value.NumberOfComponents = 1;
+    value.Registers[0] = this->Push(instruction);
+    return value;
+  }
+
+  vtkKernelValue EmitUnary(int opCode, const vtkKernelValue& arg)
+  {
+    vtkKernelValue value;
+    value.NumberOfComponents = arg.NumberOfComponents;
+    for (int cc = 0; cc < arg.NumberOfComponents; ++cc)
+    {
+      vtkKernelInstruction instruction = this->NewInstruction(opCode, arg.Registers[cc], -1);
+      value.Registers[cc] = this->Push(instruction);
+    }
+    return value;
+  }
+
+  // Component-wise operation, a scalar operand is applied to all components
+  // of a vector one.
+  vtkKernelValue EmitBinary(int opCode, const vtkKernelValue& arg0, const vtkKernelValue& arg1)
+  {
+    vtkKernelValue value;
+    value.NumberOfComponents = std::max(arg0.NumberOfComponents, arg1.NumberOfComponents);
+    for (int cc = 0; cc < value.NumberOfComponents; ++cc)
+    {
+      vtkKernelInstruction instruction =
+        this->NewInstruction(opCode, arg0.Registers[arg0.NumberOfComponents == 1 ? 0 : cc],
+          arg1.Registers[arg1.NumberOfComponents == 1 ? 0 : cc]);
+      value.Registers[cc] = this->Push(instruction);
+    }
+    return value;
+  }
+
+  vtkKernelValue Component(const vtkKernelValue& arg, int component)
+  {
+    vtkKernelValue value;
+    value.NumberOfComponents = 1;
+    value.Registers[0] = arg.Registers[component];
+    return value;
+  }
+
+  vtkKernelValue EmitDot(const vtkKernelValue& arg0, const vtkKernelValue& arg1)
+  {
+    vtkKernelValue value = this->EmitBinary(KERNEL_MULTIPLY, arg0, arg1);
+    return this->EmitBinary(KERNEL_ADD,
+      this->EmitBinary(KERNEL_ADD, this->Component(value, 0), this->Component(value, 1)),
+      this->Component(value, 2));
+  }
+
+  vtkKernelValue EmitCross(const vtkKernelValue& arg0, const vtkKernelValue& arg1)
+  {
+    vtkKernelValue value;
+    value.NumberOfComponents = 3;
+    for (int cc = 0; cc < 3; ++cc)
+    {
+      int i = (cc + 1) % 3;
+      int j = (cc + 2) % 3;
+      vtkKernelValue lhs =
+        this->EmitBinary(KERNEL_MULTIPLY, this->Component(arg0, i), this->Component(arg1, j));
+      vtkKernelValue rhs =
+        this->EmitBinary(KERNEL_MULTIPLY, this->Component(arg0, j), this->Component(arg1, i));
+      value.Registers[cc] = this->EmitBinary(KERNEL_SUBTRACT, lhs, rhs).Registers[0];
+    }
+    return value;
+  }
+
+  const vtkCalculatorVariables& Variables;
+  vtkDataSetAttributes* Attributes;
+  vtkDataSet* Coordinates;
+  vtkKernelProgram& Program;
+  const char* Position;
+  // register holding each (input, component) already loaded.
+  std::map<std::pair<int, int>, int> Loaded;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkKernelLoad(const T* data, int numberOfComponents, int component, vtkIdType begin,
+  vtkIdType n, double* result)
+{
+  const T* in = data + begin * numberOfComponents + component;
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    result[i] = static_cast<double>(in[i * numberOfComponents]);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkKernelStore(const double* const* values, int numberOfComponents, vtkIdType begin,
+  vtkIdType n, T* data)
+{
+  T* out = data + begin * numberOfComponents;
+  for (int cc = 0; cc < numberOfComponents; ++cc)
+  {
+    const double* value = values[cc];
+    for (vtkIdType i = 0; i < n; ++i)
+    {
+      out[i * numberOfComponents + cc] = static_cast<T>(value[i]);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+class vtkKernelFunctor
+{
+public:
+  vtkKernelFunctor(const vtkKernelProgram& program, vtkDataArray* output, bool replaceInvalid,
+    double replacement)
+    : Program(program)
+    , Output(output)
+    , OutputData(output->GetVoidPointer(0))
+    , ReplaceInvalid(replaceInvalid)
+    , Replacement(replacement)
+  {
+  }
+
+  void Initialize()
+  {
+    this->Registers.Local().resize(this->Program.NumberOfRegisters * vtkKernelBlockSize);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double* registers = &this->Registers.Local()[0];
+    for (vtkIdType blockBegin = begin; blockBegin < end; blockBegin += vtkKernelBlockSize)
+    {
+      vtkIdType n = std::min(vtkKernelBlockSize, end - blockBegin);
+      for (size_t cc = 0; cc < this->Program.Instructions.size(); ++cc)
+      {
+        this->Execute(this->Program.Instructions[cc], registers, blockBegin, n);
+      }
+      if (this->ReplaceInvalid)
+      {
+        this->ReplaceInvalidValues(registers, n);
+      }
+      this->Store(registers, blockBegin, n);
+    }
+  }
+
+  void Reduce() {}
+
+private:
+  void Execute(
+    const vtkKernelInstruction& instruction, double* registers, vtkIdType begin, vtkIdType n)
+  {
+    double* r = registers + instruction.Result * vtkKernelBlockSize;
+    const double* a = registers + std::max(instruction.Arg0, 0) * vtkKernelBlockSize;
+    const double* b = registers + std::max(instruction.Arg1, 0) * vtkKernelBlockSize;
+
+#define vtkKernelCase(opCode, expression)                                                     \
+  case opCode:                                                                                     \
+    for (vtkIdType i = 0; i < n; ++i)                                                              \
+    {                                                                                              \
+      r[i] = expression;                                                                           \
+    }                                                                                              \
+    break
+
+    switch (instruction.OpCode)
+    {
+      case KERNEL_LOAD:
+        this->Load(this->Program.Inputs[instruction.Input], instruction.Component, begin, n, r);
+        break;
+      case KERNEL_CONSTANT:
+        std::fill(r, r + n, instruction.Value);
+        break;
+      vtkKernelCase(KERNEL_NEGATE, -a[i]);
+      vtkKernelCase(KERNEL_ADD, a[i] + b[i]);
+      vtkKernelCase(KERNEL_SUBTRACT, a[i] - b[i]);
+      vtkKernelCase(KERNEL_MULTIPLY, a[i] * b[i]);
+      vtkKernelCase(KERNEL_DIVIDE, a[i] / b[i]);
+      vtkKernelCase(KERNEL_POWER, pow(a[i], b[i]));
+      vtkKernelCase(KERNEL_MIN, a[i] < b[i] ? a[i] : b[i]);
+      vtkKernelCase(KERNEL_MAX, a[i] > b[i] ? a[i] : b[i]);
+      vtkKernelCase(KERNEL_ABS, fabs(a[i]));
+      vtkKernelCase(KERNEL_EXP, exp(a[i]));
+      vtkKernelCase(KERNEL_CEIL, ceil(a[i]));
+      vtkKernelCase(KERNEL_FLOOR, floor(a[i]));
+      vtkKernelCase(KERNEL_LN, log(a[i]));
+      vtkKernelCase(KERNEL_LOG10, log10(a[i]));
+      vtkKernelCase(KERNEL_SQRT, sqrt(a[i]));
+      vtkKernelCase(KERNEL_SIN, sin(a[i]));
+      vtkKernelCase(KERNEL_COS, cos(a[i]));
+      vtkKernelCase(KERNEL_TAN, tan(a[i]));
+      vtkKernelCase(KERNEL_ASIN, asin(a[i]));
+      vtkKernelCase(KERNEL_ACOS, acos(a[i]));
+      vtkKernelCase(KERNEL_ATAN, atan(a[i]));
+      vtkKernelCase(KERNEL_SINH, sinh(a[i]));
+      vtkKernelCase(KERNEL_COSH, cosh(a[i]));
+      vtkKernelCase(KERNEL_TANH, tanh(a[i]));
+      vtkKernelCase(KERNEL_SIGN, a[i] > 0.0 ? 1.0 : (a[i] < 0.0 ? -1.0 : 0.0));
+      default:
+        break;
+    }
+#undef vtkKernelCase
+  }
+
+  void Load(
+    const vtkKernelInput& input, int component, vtkIdType begin, vtkIdType n, double* result)
+  {
+    if (input.Data)
+    {
+      int numberOfComponents = input.Array->GetNumberOfComponents();
+      switch (input.Array->GetDataType())
+      {
+        vtkTemplateMacro(vtkKernelLoad(static_cast<const VTK_TT*>(input.Data), numberOfComponents,
+          component, begin, n, result));
+        default:
+          break;
+      }
+    }
+    else if (input.Array)
+    {
+      for (vtkIdType i = 0; i < n; ++i)
+      {
+        result[i] = input.Array->GetComponent(begin + i, component);
+      }
+    }
+    else
+    {
+      double point[3];
+      for (vtkIdType i = 0; i < n; ++i)
+      {
+        input.DataSet->GetPoint(begin + i, point);
+        result[i] = point[component];
+      }
+    }
+  }
+
+  void ReplaceInvalidValues(double* registers, vtkIdType n)
+  {
+    const vtkKernelValue& result = this->Program.Result;
+    for (int cc = 0; cc < result.NumberOfComponents; ++cc)
+    {
+      double* value = registers + result.Registers[cc] * vtkKernelBlockSize;
+      for (vtkIdType i = 0; i < n; ++i)
+      {
+        if (!std::isfinite(value[i]))
+        {
+          value[i] = this->Replacement;
+        }
+      }
+    }
+  }
+
+  void Store(double* registers, vtkIdType begin, vtkIdType n)
+  {
+    const vtkKernelValue& result = this->Program.Result;
+    double* values[3];
+    for (int cc = 0; cc < result.NumberOfComponents; ++cc)
+    {
+      values[cc] = registers + result.Registers[cc] * vtkKernelBlockSize;
+    }
+    switch (this->Output->GetDataType())
+    {
+      vtkTemplateMacro(vtkKernelStore(values, result.NumberOfComponents, begin, n,
+        static_cast<VTK_TT*>(this->OutputData)));
+      default:
+        break;
+    }
+  }
+
+  const vtkKernelProgram& Program;
+  vtkDataArray* Output;
+  void* OutputData;
+  bool ReplaceInvalid;
+  double Replacement;
+  vtkSMPThreadLocal<std::vector<double> > Registers;
+};
+}
+
+class vtkPVArrayCalculator::vtkInternals
+{
+public:
+  vtkCalculatorVariables Variables;
+};
+
 vtkStandardNewMacro(vtkPVArrayCalculator);
 // ----------------------------------------------------------------------------
 vtkPVArrayCalculator::vtkPVArrayCalculator()
 {
+  this->UseCompiledKernel = false;
+  this->Internals = new vtkInternals();
 }
 
 // ----------------------------------------------------------------------------
 vtkPVArrayCalculator::~vtkPVArrayCalculator()
 {
+  delete this->Internals;
 }
 
 // ----------------------------------------------------------------------------
@@ -95,11 +932,19 @@ void vtkPVArrayCalculator::UpdateArrayAndVariableNames(
   // this->Modified().
   this->RemoveAllVariables();
 
+  // The same variables are recorded for the compiled kernel.
+  vtkCalculatorVariables& variables = this->Internals->Variables;
+  variables.clear();
+
   // Add coordinate scalar and vector variables
   this->AddCoordinateScalarVariable("coordsX", 0);
   this->AddCoordinateScalarVariable("coordsY", 1);
   this->AddCoordinateScalarVariable("coordsZ", 2);
   this->AddCoordinateVectorVariable("coords", 0, 1, 2);
+  vtkAddCalculatorVariable(variables, "coordsX", NULL, 0);
+  vtkAddCalculatorVariable(variables, "coordsY", NULL, 1);
+  vtkAddCalculatorVariable(variables, "coordsZ", NULL, 2);
+  vtkAddCalculatorVariable(variables, "coords", NULL, 0, 1, 2);
 
   // add non-coordinate scalar and vector variables
   int numberArays = inDataAttrs->GetNumberOfArrays(); // the input
@@ -114,6 +959,8 @@ void vtkPVArrayCalculator::UpdateArrayAndVariableNames(
     {
       this->AddScalarVariable(array_name, array_name, 0);
       this->AddScalarVariable(vtkQuoteString(array_name).c_str(), array_name);
+      vtkAddCalculatorVariable(variables, array_name, array_name, 0);
+      vtkAddCalculatorVariable(variables, vtkQuoteString(array_name), array_name, 0);
     }
     else
     {
@@ -142,12 +989,19 @@ void vtkPVArrayCalculator::UpdateArrayAndVariableNames(
 
         std::for_each(
           possible_names.begin(), possible_names.end(), add_scalar_variables(this, array_name, i));
+        for (std::set<std::string>::const_iterator iter = possible_names.begin();
+             iter != possible_names.end(); ++iter)
+        {
+          vtkAddCalculatorVariable(variables, *iter, array_name, i);
+        }
       }
 
       if (numberComps == 3)
       {
         this->AddVectorArrayName(array_name, 0, 1, 2);
         this->AddVectorVariable(vtkQuoteString(array_name).c_str(), array_name, 0, 1, 2);
+        vtkAddCalculatorVariable(variables, array_name, array_name, 0, 1, 2);
+        vtkAddCalculatorVariable(variables, vtkQuoteString(array_name), array_name, 0, 1, 2);
       }
     }
   }
@@ -197,13 +1051,86 @@ int vtkPVArrayCalculator::RequestData(
     // put is the input of a (some) subsequent calculator(s) or the user changes
     // the input of a downstream calculator.
     this->UpdateArrayAndVariableNames(input, dataAttrs);
+
+    vtkDataObject* output =
+      outputVector->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT());
+    if (this->UseCompiledKernel && this->EvaluateCompiledKernel(input, output, attributeType))
+    {
+      return 1;
+    }
   }
 
   return this->Superclass::RequestData(request, inputVector, outputVector);
 }
 
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculator::EvaluateCompiledKernel(
+  vtkDataObject* input, vtkDataObject* output, int attributeType)
+{
+  if (!this->Function || !*this->Function || this->CoordinateResults || !this->ResultArrayName)
+  {
+    return false;
+  }
+
+  vtkDataSetAttributes* inDataAttrs = input->GetAttributes(attributeType);
+  vtkIdType numTuples = input->GetNumberOfElements(attributeType);
+  vtkDataSet* coordinates =
+    attributeType == vtkDataObject::POINT ? vtkDataSet::SafeDownCast(input) : NULL;
+
+  vtkKernelProgram program;
+  vtkKernelCompiler compiler(this->Internals->Variables, inDataAttrs, coordinates, program);
+  if (!compiler.Compile(this->Function))
+  {
+    vtkDebugMacro("Function not supported by the compiled kernel: " << this->Function);
+    return false;
+  }
+  bool scalarResult = program.Result.NumberOfComponents == 1;
+  if ((this->ResultNormals || this->ResultTCoords) && scalarResult)
+  {
+    return false;
+  }
+
+  vtkSmartPointer<vtkDataArray> result;
+  result.TakeReference(vtkDataArray::CreateDataArray(this->ResultArrayType));
+  if (!result || !result->HasStandardMemoryLayout() || result->GetDataType() == VTK_BIT)
+  {
+    return false;
+  }
+  result->SetNumberOfComponents(program.Result.NumberOfComponents);
+  result->SetNumberOfTuples(numTuples);
+  result->SetName(this->ResultArrayName);
+
+  vtkKernelFunctor functor(
+    program, result, this->ReplaceInvalidValues != 0, this->ReplacementValue);
+  vtkSMPTools::For(0, numTuples, functor);
+
+  // Attach the result the same way vtkArrayCalculator does.
+  output->ShallowCopy(input);
+  vtkDataSetAttributes* outDataAttrs = output->GetAttributes(attributeType);
+  if (scalarResult)
+  {
+    outDataAttrs->AddArray(result);
+    outDataAttrs->SetActiveScalars(this->ResultArrayName);
+  }
+  else if (this->ResultNormals)
+  {
+    outDataAttrs->SetNormals(result);
+  }
+  else if (this->ResultTCoords)
+  {
+    outDataAttrs->SetTCoords(result);
+  }
+  else
+  {
+    outDataAttrs->AddArray(result);
+    outDataAttrs->SetActiveVectors(this->ResultArrayName);
+  }
+  return true;
+}
+
 // ----------------------------------------------------------------------------
 void vtkPVArrayCalculator::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "UseCompiledKernel: " << this->UseCompiledKernel << endl;
 }
@@ -24,6 +24,12 @@
  *  their mapping with the input fields. We extend vtkArrayCalculator to
  *  automatically add scalar/vector fields mapping using the array available in
  *  the input.
+ *
+ *  When UseCompiledKernel is on, the function is compiled into a kernel that
+ *  evaluates blocks of tuples directly from the array memory, in parallel
+ *  using vtkSMPTools. Functions or options the kernel does not support
+ *  (e.g. if(), comparisons or CoordinateResults) are evaluated with
+ *  vtkFunctionParser as usual.
  * @sa
  *  vtkArrayCalculator vtkFunctionParser
 */
@@ -45,6 +51,23 @@ public:
 
   static vtkPVArrayCalculator* New();
 
+  //@{
+  /**
+   * When on, evaluate the function with a compiled, multi-threaded kernel
+   * whenever possible instead of interpreting it one tuple at a time.
+   * The kernel follows IEEE arithmetic: invalid operations (e.g. division by
+   * zero, sqrt of a negative number) produce inf or nan. When
+   * ReplaceInvalidValues is on, non-finite results are replaced by
+   * ReplacementValue. Unlike vtkFunctionParser, which replaces the result of
+   * each invalid operation, only the final values are checked, so e.g.
+   * min(1/0, 2) gives 2 instead of min(ReplacementValue, 2).
+   * Default is off.
+   */
+  vtkSetMacro(UseCompiledKernel, bool);
+  vtkGetMacro(UseCompiledKernel, bool);
+  vtkBooleanMacro(UseCompiledKernel, bool);
+  //@}
+
 protected:
   vtkPVArrayCalculator();
   ~vtkPVArrayCalculator() override;
@@ -62,11 +85,23 @@ protected:
    * RequestData() only.
    */
   void UpdateArrayAndVariableNames(vtkDataObject* theInputObj, vtkDataSetAttributes* inDataAttrs);
+  //@}
+
+  /**
+   * Evaluate the function with the compiled kernel and fill the output.
+   * Returns false, without touching the output, if the function or the
+   * current settings are not supported by the kernel.
+   */
+  bool EvaluateCompiledKernel(vtkDataObject* input, vtkDataObject* output, int attributeType);
+
+  bool UseCompiledKernel;
 
 private:
   vtkPVArrayCalculator(const vtkPVArrayCalculator&) = delete;
   void operator=(const vtkPVArrayCalculator&) = delete;
+
+  class vtkInternals;
+  vtkInternals* Internals;
 };
-//@}
 
 #endif
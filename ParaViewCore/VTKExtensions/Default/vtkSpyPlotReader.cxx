@@ -98,6 +98,7 @@ vtkSpyPlotReader::vtkSpyPlotReader()
   this->ComputeDerivedVariables = 1;
   this->DownConvertVolumeFraction = 1;
   this->MergeXYZComponents = 1;
+  this->BlockCacheSize = 0;
 
   // this has all of the processes.
   this->GlobalController = 0;
@@ -1356,6 +1357,29 @@ void vtkSpyPlotReader::SetMergeXYZComponents(int merge)
   this->MergeXYZComponents = merge;
   this->Modified();
 }
+
+//-----------------------------------------------------------------------------
+void vtkSpyPlotReader::SetBlockCacheSize(int size)
+{
+  if (size < 0)
+  {
+    size = 0;
+  }
+  if (size == this->BlockCacheSize)
+  {
+    return;
+  }
+  vtkSpyPlotReaderMap::MapOfStringToSPCTH::iterator mapIt;
+  for (mapIt = this->Map->Files.begin(); mapIt != this->Map->Files.end(); ++mapIt)
+  {
+    if (mapIt->second)
+    {
+      mapIt->second->SetBlockCacheSize(static_cast<unsigned long>(size) * 1024);
+    }
+  }
+  this->BlockCacheSize = size;
+  this->Modified();
+}
 //-----------------------------------------------------------------------------
 void vtkSpyPlotReader::PrintBlockList(vtkNonOverlappingAMR* hbds, int vtkNotUsed(myProcId))
 {
@@ -1430,6 +1454,8 @@ void vtkSpyPlotReader::PrintSelf(ostream& os, vtkIndent indent)
     os << "false" << endl;
   }
 
+  os << "BlockCacheSize: " << this->BlockCacheSize << endl;
+
   os << "GenerateLevelArray: ";
   if (this->GenerateLevelArray)
   {
@@ -199,6 +199,17 @@ public:
   vtkBooleanMacro(MergeXYZComponents, int);
   //@}
 
+  //@{
+  /**
+   * Memory, in megabytes, each file reader on this process may use to keep
+   * decoded cell data of time steps and arrays that are not currently
+   * requested, so that going back to them does not read and decode the file
+   * again. 0 by default, i.e. nothing is kept.
+   */
+  void SetBlockCacheSize(int size);
+  vtkGetMacro(BlockCacheSize, int);
+  //@}
+
   //@{
   /**
    * Get the time step range.
@@ -391,6 +402,8 @@ protected:
 
   int MergeXYZComponents;
 
+  int BlockCacheSize;
+
   // This flag is used to determine if core meta-data needs to be re-read.
   bool FileNameChanged;
 
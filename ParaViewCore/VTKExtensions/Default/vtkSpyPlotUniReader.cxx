@@ -8,6 +8,7 @@
 #include "vtkSpyPlotBlock.h"
 #include "vtkSpyPlotIStream.h"
 #include "vtkUnsignedCharArray.h"
+#include <algorithm>
 #include <sstream>
 #include <vector>
 #include <vtksys/RegularExpression.hxx>
@@ -79,6 +80,8 @@ vtkSpyPlotUniReader::vtkSpyPlotUniReader()
   this->HaveInformation = 0;
   this->DownConvertVolumeFraction = 1;
   this->DataTypeChanged = 0;
+  this->BlockCacheSize = 0;
+  this->BlockCacheTime = 0;
   this->GeomTimeStep = -1; // Indicate that geometry will have to be loaded
   this->NeedToCheck = 1;   // Indicates non-geometric data needs to be checked
   if (!this->HaveInformation)
@@ -291,7 +294,11 @@ int vtkSpyPlotUniReader::MakeCurrent()
   }
 
   this->NeedToCheck = 0;
+  this->BlockCacheTime++;
 
+  // Blocks of other time steps are only kept when there is a cache to keep
+  // them in, and never when the volume fraction type they were decoded to is
+  // no longer the requested one
   for (dump = 0; dump < this->NumberOfDataDumps; ++dump)
   {
     if (dump != this->CurrentTimeStep)
@@ -301,22 +308,10 @@ int vtkSpyPlotUniReader::MakeCurrent()
       for (var = 0; var < dp->NumVars; ++var)
       {
         vtkSpyPlotUniReader::Variable* cv = dp->Variables + var;
-        if (cv->DataBlocks)
+        if (cv->DataBlocks &&
+          (this->BlockCacheSize == 0 || (this->DataTypeChanged && this->IsVolumeFraction(cv))))
         {
-          int ca;
-          for (ca = 0; ca < dp->ActualNumberOfBlocks; ++ca)
-          {
-            if (cv->DataBlocks[ca])
-            {
-              cv->DataBlocks[ca]->Delete();
-              cv->DataBlocks[ca] = 0;
-            }
-          }
-          vtkDebugMacro("* Delete Data blocks for variable: " << cv->Name);
-          delete[] cv->DataBlocks;
-          cv->DataBlocks = 0;
-          delete[] cv->GhostCellsFixed;
-          cv->GhostCellsFixed = 0;
+          this->ReleaseDataBlocks(dp, cv);
         }
       }
     }
@@ -339,23 +334,13 @@ int vtkSpyPlotUniReader::MakeCurrent()
       blocksExists = 1;
     }
     // Did we create data blocks that we do not need any more
-    if ((!this->CellArraySelection->ArrayIsEnabled(var->Name)) ||
-      (this->DataTypeChanged && this->IsVolumeFraction(var)))
+    int typeChanged = this->DataTypeChanged && this->IsVolumeFraction(var);
+    if ((!this->CellArraySelection->ArrayIsEnabled(var->Name)) || typeChanged)
     {
-      if (var->DataBlocks)
+      if (var->DataBlocks && (this->BlockCacheSize == 0 || typeChanged))
       {
         vtkDebugMacro(" ** Variable " << var->Name << " was unselected, so remove");
-        int dataBlock;
-        for (dataBlock = 0; dataBlock < dp->ActualNumberOfBlocks; ++dataBlock)
-        {
-          var->DataBlocks[dataBlock]->Delete();
-          var->DataBlocks[dataBlock] = 0;
-        }
-        delete[] var->DataBlocks;
-        var->DataBlocks = 0;
-        delete[] var->GhostCellsFixed;
-        var->GhostCellsFixed = 0;
-        vtkDebugMacro("* Delete Data blocks for variable: " << var->Name);
+        this->ReleaseDataBlocks(dp, var);
       }
       vtkDebugMacro(" *** Ignore variable: " << var->Name);
       if (!this->CellArraySelection->ArrayIsEnabled(var->Name))
@@ -363,6 +348,7 @@ int vtkSpyPlotUniReader::MakeCurrent()
         continue;
       }
     }
+    var->LastUsed = this->BlockCacheTime;
 
     if ((needMarkers || this->CellArraySelection->ArrayIsEnabled(var->Name)) && !var->DataBlocks)
     {
@@ -477,9 +463,92 @@ int vtkSpyPlotUniReader::MakeCurrent()
   }
 
   this->DataTypeChanged = 0;
+  if (this->BlockCacheSize > 0)
+  {
+    this->TrimBlockCache();
+  }
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+unsigned long vtkSpyPlotUniReader::GetDataBlocksMemorySize(
+  vtkSpyPlotUniReader::DataDump* dp, vtkSpyPlotUniReader::Variable* var)
+{
+  unsigned long size = 0;
+  if (var->DataBlocks)
+  {
+    for (int block = 0; block < dp->ActualNumberOfBlocks; ++block)
+    {
+      if (var->DataBlocks[block])
+      {
+        size += var->DataBlocks[block]->GetActualMemorySize();
+      }
+    }
+  }
+  return size;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long vtkSpyPlotUniReader::ReleaseDataBlocks(
+  vtkSpyPlotUniReader::DataDump* dp, vtkSpyPlotUniReader::Variable* var)
+{
+  unsigned long size = this->GetDataBlocksMemorySize(dp, var);
+  if (var->DataBlocks)
+  {
+    for (int block = 0; block < dp->ActualNumberOfBlocks; ++block)
+    {
+      if (var->DataBlocks[block])
+      {
+        var->DataBlocks[block]->Delete();
+      }
+    }
+    vtkDebugMacro("* Delete Data blocks for variable: " << var->Name);
+    delete[] var->DataBlocks;
+    var->DataBlocks = 0;
+    delete[] var->GhostCellsFixed;
+    var->GhostCellsFixed = 0;
+  }
+  return size;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSpyPlotUniReader::TrimBlockCache()
+{
+  struct CachedVariable
+  {
+    unsigned long LastUsed;
+    int Dump;
+    int VariableIndex;
+    bool operator<(const CachedVariable& other) const { return this->LastUsed < other.LastUsed; }
+  };
+
+  // Everything decoded but not used by the last MakeCurrent is a candidate
+  std::vector<CachedVariable> cached;
+  unsigned long cachedSize = 0;
+  for (int dump = 0; dump < this->NumberOfDataDumps; ++dump)
+  {
+    vtkSpyPlotUniReader::DataDump* dp = this->DataDumps + dump;
+    for (int var = 0; var < dp->NumVars; ++var)
+    {
+      vtkSpyPlotUniReader::Variable* cv = dp->Variables + var;
+      if (cv->DataBlocks && cv->LastUsed != this->BlockCacheTime)
+      {
+        CachedVariable entry = { cv->LastUsed, dump, var };
+        cached.push_back(entry);
+        cachedSize += this->GetDataBlocksMemorySize(dp, cv);
+      }
+    }
+  }
+
+  std::sort(cached.begin(), cached.end());
+  std::vector<CachedVariable>::iterator it;
+  for (it = cached.begin(); it != cached.end() && cachedSize > this->BlockCacheSize; ++it)
+  {
+    vtkSpyPlotUniReader::DataDump* dp = this->DataDumps + it->Dump;
+    cachedSize -= this->ReleaseDataBlocks(dp, dp->Variables + it->VariableIndex);
+  }
+}
+
 //-----------------------------------------------------------------------------
 void vtkSpyPlotUniReader::PrintMemoryUsage()
 {
@@ -1335,6 +1404,7 @@ void vtkSpyPlotUniReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "TimeRange: [" << this->TimeRange[0] << ", " << this->TimeRange[1] << "]" << endl;
   os << indent << "CurrentTime: " << this->CurrentTime << endl;
   os << indent << "DataTypeChanged: " << this->DataTypeChanged << endl;
+  os << indent << "BlockCacheSize: " << this->BlockCacheSize << endl;
   os << indent << "NumberOfCellFields: " << this->NumberOfCellFields << endl;
   os << indent << "NeedToCheck: " << this->NeedToCheck << endl;
 }
@@ -1547,6 +1617,8 @@ int vtkSpyPlotUniReader::ReadDataDumps(vtkSpyPlotIStream* spis)
       variable->Material = -1;
       variable->Index = -1;
       variable->DataBlocks = 0;
+      variable->GhostCellsFixed = 0;
+      variable->LastUsed = 0;
       int var = dh->SavedVariables[fieldCnt];
       if (var >= this->NumberOfPossibleCellFields)
       {
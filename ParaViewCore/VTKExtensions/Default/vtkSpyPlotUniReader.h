@@ -180,6 +180,7 @@ public:
     CellMaterialField* MaterialField;
     vtkDataArray** DataBlocks;
     int* GhostCellsFixed;
+    unsigned long LastUsed;
   };
   struct DataDump
   {
@@ -231,6 +232,19 @@ public:
   vtkSetMacro(DataTypeChanged, int);
   void SetDownConvertVolumeFraction(int vf);
 
+  //@{
+  /**
+   * Set and get the amount of memory, in kibibytes, the reader may use to keep
+   * decoded cell data blocks of time steps and arrays that are not currently
+   * requested. When the time step or the array selection changes back, blocks
+   * found in the cache are reused instead of being read and run-length decoded
+   * again. Least recently used blocks are released first. 0 (the default)
+   * releases them as soon as they are not needed.
+   */
+  vtkSetMacro(BlockCacheSize, unsigned long);
+  vtkGetMacro(BlockCacheSize, unsigned long);
+  //@}
+
 protected:
   vtkSpyPlotUniReader();
   ~vtkSpyPlotUniReader() override;
@@ -251,6 +265,14 @@ private:
 
   vtkDataArray* GetMaterialField(const int& block, const int& materialIndex, const char* Id);
 
+  // Release the decoded blocks of a variable and return their size in kibibytes
+  unsigned long ReleaseDataBlocks(DataDump* dp, Variable* var);
+  unsigned long GetDataBlocksMemorySize(DataDump* dp, Variable* var);
+
+  // Release least recently used blocks until the ones that are not part of
+  // the current request fit in BlockCacheSize
+  void TrimBlockCache();
+
   // Header information
   char FileDescription[128];
   int FileVersion;
@@ -307,6 +329,10 @@ private:
   int DataTypeChanged;
   int DownConvertVolumeFraction;
 
+  // Decoded block cache budget and use counter for LRU eviction
+  unsigned long BlockCacheSize;
+  unsigned long BlockCacheTime;
+
   int NumberOfCellFields;
 
   vtkDataArraySelection* CellArraySelection;
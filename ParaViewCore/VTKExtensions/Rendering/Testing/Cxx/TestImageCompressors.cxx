@@ -13,6 +13,7 @@
 
 =========================================================================*/
 
+#include "vtkDeltaImageCompressor.h"
 #include "vtkImageCompressor.h"
 #include "vtkImageData.h"
 #include "vtkLZ4Compressor.h"
@@ -22,10 +23,13 @@
 #include "vtkSmartPointer.h"
 #include "vtkSquirtCompressor.h"
 #include "vtkTesting.h"
+#include "vtkTiledSquirtCompressor.h"
 #include "vtkTimerLog.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkZlibImageCompressor.h"
 
+#include <algorithm>
+#include <cstring>
 #include <map>
 #include <string>
 #include <vtksys/CommandLineArguments.hxx>
@@ -48,10 +52,10 @@ public:
 };
 typedef std::map<std::string, Data> MapType;
 
-bool DoTest(Data& data, vtkImageCompressor* compressor, vtkUnsignedCharArray* input)
+bool DoTest(Data& data, vtkImageCompressor* compressor, vtkUnsignedCharArray* input,
+  vtkUnsignedCharArray* outputDeCompressed)
 {
   vtkNew<vtkUnsignedCharArray> outputCompressed;
-  vtkNew<vtkUnsignedCharArray> outputDeCompressed;
   outputDeCompressed->SetNumberOfComponents(input->GetNumberOfComponents());
   outputDeCompressed->SetNumberOfTuples(input->GetNumberOfTuples());
 
@@ -68,7 +72,7 @@ bool DoTest(Data& data, vtkImageCompressor* compressor, vtkUnsignedCharArray* in
   data.CompressTime += timer->GetElapsedTime();
 
   compressor->SetInput(outputCompressed.Get());
-  compressor->SetOutput(outputDeCompressed.Get());
+  compressor->SetOutput(outputDeCompressed);
   timer->StartTimer();
   if (!compressor->Decompress())
   {
@@ -81,6 +85,62 @@ bool DoTest(Data& data, vtkImageCompressor* compressor, vtkUnsignedCharArray* in
   return true;
 }
 
+bool DoTest(Data& data, vtkImageCompressor* compressor, vtkUnsignedCharArray* input)
+{
+  vtkNew<vtkUnsignedCharArray> outputDeCompressed;
+  return DoTest(data, compressor, input, outputDeCompressed.Get());
+}
+
+// Compresses `input` in LossLessMode and checks that the color bytes come back
+// unchanged. SQUIRT always quantizes opacity to 4 bits, so the alpha of RGBA
+// inputs is only compared to that precision.
+bool DoLossLessTest(Data& data, vtkImageCompressor* compressor, vtkUnsignedCharArray* input)
+{
+  vtkNew<vtkUnsignedCharArray> outputDeCompressed;
+  compressor->SetLossLessMode(1);
+  if (!DoTest(data, compressor, input, outputDeCompressed.Get()))
+  {
+    return false;
+  }
+
+  const int numComps = input->GetNumberOfComponents();
+  const vtkIdType numValues = input->GetNumberOfTuples() * numComps;
+  const unsigned char* expected = input->GetPointer(0);
+  const unsigned char* actual = outputDeCompressed->GetPointer(0);
+  for (vtkIdType cc = 0; cc < numValues; ++cc)
+  {
+    const bool alpha = (numComps == 4 && cc % 4 == 3);
+    if (alpha ? (expected[cc] / 16 != actual[cc] / 16) : (expected[cc] != actual[cc]))
+    {
+      cerr << "Lossless round trip differs at value " << cc << ": " << int(expected[cc])
+           << " != " << int(actual[cc]) << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compresses `input` with the delta compressor, on top of the frames it
+// already compressed, and checks that the decompressed frame is exactly
+// `input`.
+bool DoDeltaTest(Data& data, vtkDeltaImageCompressor* compressor, vtkUnsignedCharArray* input)
+{
+  vtkNew<vtkUnsignedCharArray> outputDeCompressed;
+  if (!DoTest(data, compressor, input, outputDeCompressed.Get()))
+  {
+    return false;
+  }
+  const vtkIdType numValues = input->GetNumberOfTuples() * input->GetNumberOfComponents();
+  if (outputDeCompressed->GetNumberOfTuples() != input->GetNumberOfTuples() ||
+    outputDeCompressed->GetNumberOfComponents() != input->GetNumberOfComponents() ||
+    memcmp(outputDeCompressed->GetPointer(0), input->GetPointer(0), numValues) != 0)
+  {
+    cerr << "Delta compressed frame differs from its input." << endl;
+    return false;
+  }
+  return true;
+}
+
 int TestImageCompressors(int argc, char* argv[])
 {
   int max_count = 10;
@@ -120,6 +180,21 @@ int TestImageCompressors(int argc, char* argv[])
     vtkUnsignedCharArray::SafeDownCast(image->GetPointData()->GetScalars());
   vtkIdType uncompressedSize = input->GetNumberOfTuples() * input->GetNumberOfComponents();
 
+  // The same image with RGBA pixels if the input is RGB and the reverse,
+  // so that both pixel formats are covered.
+  vtkNew<vtkUnsignedCharArray> otherInput;
+  const int otherComps = input->GetNumberOfComponents() == 4 ? 3 : 4;
+  otherInput->SetNumberOfComponents(otherComps);
+  otherInput->SetNumberOfTuples(input->GetNumberOfTuples());
+  for (vtkIdType cc = 0; cc < input->GetNumberOfTuples(); ++cc)
+  {
+    for (int comp = 0; comp < otherComps; ++comp)
+    {
+      otherInput->SetTypedComponent(cc, comp,
+        comp < 3 ? input->GetTypedComponent(cc, comp) : static_cast<unsigned char>(255));
+    }
+  }
+
   MapType datas;
   for (int cc = 0; cc < max_count; cc++)
   {
@@ -168,6 +243,79 @@ int TestImageCompressors(int argc, char* argv[])
       }
     }
 
+    // Compress the same image twice so that the second frame exercises the
+    // delta path, which should send no tiles at all, then a frame in which
+    // only a small block changed.
+    vtkNew<vtkDeltaImageCompressor> delta;
+    delta->SetImageResolution(image->GetDimensions()[0], image->GetDimensions()[1]);
+    delta->ResetKeyFrame();
+    Data& keyFrame = datas["DELTA (key frame)"];
+    Data& unchangedFrame = datas["DELTA (unchanged frame)"];
+    Data& changedFrame = datas["DELTA (partly changed frame)"];
+    if (!DoDeltaTest(keyFrame, delta.Get(), input) ||
+      !DoDeltaTest(unchangedFrame, delta.Get(), input))
+    {
+      return TEST_FAILED;
+    }
+    if (unchangedFrame.CompressedSize > 64)
+    {
+      cerr << "Unchanged frame compressed to " << unchangedFrame.CompressedSize << " bytes."
+           << endl;
+      return TEST_FAILED;
+    }
+
+    vtkNew<vtkUnsignedCharArray> changedInput;
+    changedInput->DeepCopy(input);
+    const int* dims = image->GetDimensions();
+    const int numComps = input->GetNumberOfComponents();
+    for (int y = dims[1] / 2; y < std::min(dims[1] / 2 + 10, dims[1]); ++y)
+    {
+      for (int x = dims[0] / 3; x < std::min(dims[0] / 3 + 20, dims[0]); ++x)
+      {
+        for (int comp = 0; comp < numComps; ++comp)
+        {
+          changedInput->SetTypedComponent(static_cast<vtkIdType>(y) * dims[0] + x, comp,
+            static_cast<unsigned char>(255 - input->GetTypedComponent(y * dims[0] + x, comp)));
+        }
+      }
+    }
+    if (!DoDeltaTest(changedFrame, delta.Get(), changedInput.Get()))
+    {
+      return TEST_FAILED;
+    }
+    if (changedFrame.CompressedSize >= keyFrame.CompressedSize)
+    {
+      cerr << "Partly changed frame compressed to " << changedFrame.CompressedSize
+           << " bytes, no less than the key frame." << endl;
+      return TEST_FAILED;
+    }
+
+    vtkNew<vtkTiledSquirtCompressor> tiledSquirt;
+    tiledSquirt->SetSquirtLevel(0);
+    if (!DoTest(datas["TILED SQUIRT (squirt-level: 0)"], tiledSquirt.Get(), input))
+    {
+      return TEST_FAILED;
+    }
+
+    // The lossless round trip must be exact, for RGB and RGBA images.
+    tiledSquirt->SetSquirtLevel(5);
+    if (!DoLossLessTest(datas["TILED SQUIRT (lossless)"], tiledSquirt.Get(), input) ||
+      !DoLossLessTest(datas["TILED SQUIRT (lossless, other components)"], tiledSquirt.Get(),
+        otherInput))
+    {
+      return TEST_FAILED;
+    }
+
+    if (test_lossy)
+    {
+      tiledSquirt->SetSquirtLevel(3);
+      tiledSquirt->SetLossLessMode(0);
+      if (!DoTest(datas["TILED SQUIRT (squirt-level: 3)"], tiledSquirt.Get(), input))
+      {
+        return TEST_FAILED;
+      }
+    }
+
     vtkNew<vtkZlibImageCompressor> zlib;
     zlib->SetCompressionLevel(1);
     if (!DoTest(datas["ZLIB (compression-level: 1, color-space: 0)"], zlib.Get(), input))
@@ -0,0 +1,225 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterMultiBlock.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the surfaces vtkPVGeometryFilter extracts concurrently from the
+// leaves of a multiblock dataset match the surfaces it extracts from each leaf
+// on its own, including for leaves that share a dataset or its points.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+vtkIdType GridPointId(int i, int j, int k)
+{
+  return i + 3 * j + 9 * k;
+}
+
+// Hexahedra of the i-th column of a 2x2x1 grid of cells laid on the points.
+vtkSmartPointer<vtkUnstructuredGrid> NewHexColumn(vtkPoints* points, int i)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->Allocate(2);
+  for (int j = 0; j < 2; j++)
+  {
+    vtkIdType ids[8] = { GridPointId(i, j, 0), GridPointId(i + 1, j, 0),
+      GridPointId(i + 1, j + 1, 0), GridPointId(i, j + 1, 0), GridPointId(i, j, 1),
+      GridPointId(i + 1, j, 1), GridPointId(i + 1, j + 1, 1), GridPointId(i, j + 1, 1) };
+    grid->InsertNextCell(VTK_HEXAHEDRON, 8, ids);
+  }
+  vtkNew<vtkDoubleArray> cellValues;
+  cellValues->SetName("CellValues");
+  cellValues->InsertNextValue(i);
+  cellValues->InsertNextValue(i + 0.5);
+  grid->GetCellData()->AddArray(cellValues.GetPointer());
+  return grid;
+}
+
+bool SameArray(vtkDataArray* expected, vtkDataArray* actual)
+{
+  if (!actual || expected->GetNumberOfTuples() != actual->GetNumberOfTuples() ||
+    expected->GetNumberOfComponents() != actual->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < expected->GetNumberOfTuples(); cc++)
+  {
+    for (int comp = 0; comp < expected->GetNumberOfComponents(); comp++)
+    {
+      if (expected->GetComponent(cc, comp) != actual->GetComponent(cc, comp))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SameCells(vtkCellArray* expected, vtkCellArray* actual)
+{
+  if (!expected || !actual)
+  {
+    return expected == actual;
+  }
+  return expected->GetNumberOfCells() == actual->GetNumberOfCells() &&
+    SameArray(expected->GetData(), actual->GetData());
+}
+
+// Compares the geometry and the attributes of the expected surface. The
+// composite output has additional arrays to identify the blocks.
+bool SameSurface(vtkPolyData* expected, vtkPolyData* actual)
+{
+  if (!actual || expected->GetNumberOfPoints() != actual->GetNumberOfPoints() ||
+    expected->GetNumberOfCells() != actual->GetNumberOfCells())
+  {
+    return false;
+  }
+  if (expected->GetNumberOfPoints() > 0 &&
+    !SameArray(expected->GetPoints()->GetData(), actual->GetPoints()->GetData()))
+  {
+    return false;
+  }
+  if (!SameCells(expected->GetVerts(), actual->GetVerts()) ||
+    !SameCells(expected->GetLines(), actual->GetLines()) ||
+    !SameCells(expected->GetPolys(), actual->GetPolys()) ||
+    !SameCells(expected->GetStrips(), actual->GetStrips()))
+  {
+    return false;
+  }
+  for (int cc = 0; cc < expected->GetPointData()->GetNumberOfArrays(); cc++)
+  {
+    vtkDataArray* array = expected->GetPointData()->GetArray(cc);
+    if (array && !SameArray(array, actual->GetPointData()->GetArray(array->GetName())))
+    {
+      return false;
+    }
+  }
+  for (int cc = 0; cc < expected->GetCellData()->GetNumberOfArrays(); cc++)
+  {
+    vtkDataArray* array = expected->GetCellData()->GetArray(cc);
+    if (array && !SameArray(array, actual->GetCellData()->GetArray(array->GetName())))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestPVGeometryFilterMultiBlock(int, char* [])
+{
+  vtkSMPTools::Initialize();
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(16);
+  sphere->SetPhiResolution(16);
+  sphere->Update();
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(4, 5, 6);
+  image->SetOrigin(3, 0, 0);
+  image->AllocateScalars(VTK_DOUBLE, 1);
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType cc = 0; cc < scalars->GetNumberOfTuples(); cc++)
+  {
+    scalars->SetTuple1(cc, static_cast<double>(cc));
+  }
+
+  vtkNew<vtkPoints> gridPoints;
+  for (int k = 0; k < 2; k++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        gridPoints->InsertNextPoint(i, j - 4, k);
+      }
+    }
+  }
+
+  // Two grids share their points and the sphere is used by two blocks.
+  vtkNew<vtkMultiBlockDataSet> nested;
+  nested->SetBlock(0, NewHexColumn(gridPoints.GetPointer(), 0));
+  nested->SetBlock(1, NewHexColumn(gridPoints.GetPointer(), 1));
+  nested->SetBlock(2, sphere->GetOutput());
+
+  vtkNew<vtkMultiBlockDataSet> input;
+  input->SetBlock(0, sphere->GetOutput());
+  input->SetBlock(1, image.GetPointer());
+  input->SetBlock(2, NULL);
+  input->SetBlock(3, nested.GetPointer());
+  for (unsigned int cc = 4; cc < 12; cc++)
+  {
+    vtkNew<vtkSphereSource> other;
+    other->SetCenter(cc, 0, 0);
+    other->SetRadius(0.25);
+    other->Update();
+    input->SetBlock(cc, other->GetOutput());
+  }
+
+  vtkNew<vtkPVGeometryFilter> compositeFilter;
+  compositeFilter->SetUseOutline(0);
+  compositeFilter->SetInputData(input.GetPointer());
+  compositeFilter->Update();
+  vtkMultiBlockDataSet* output =
+    vtkMultiBlockDataSet::SafeDownCast(compositeFilter->GetOutputDataObject(0));
+  if (!output)
+  {
+    cerr << "Expected a multiblock output." << endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(input->NewIterator());
+  int numberOfLeaves = 0;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    vtkNew<vtkPVGeometryFilter> leafFilter;
+    leafFilter->SetUseOutline(0);
+    leafFilter->SetInputData(iter->GetCurrentDataObject());
+    leafFilter->Update();
+    vtkPolyData* expected = vtkPolyData::SafeDownCast(leafFilter->GetOutputDataObject(0));
+    vtkPolyData* actual = vtkPolyData::SafeDownCast(output->GetDataSet(iter));
+    if (!expected || !SameSurface(expected, actual))
+    {
+      cerr << "Surface of block " << iter->GetCurrentFlatIndex()
+           << " differs from the one extracted from the block alone." << endl;
+      return EXIT_FAILURE;
+    }
+    numberOfLeaves++;
+  }
+  if (numberOfLeaves != 13)
+  {
+    cerr << "Unexpected number of leaves: " << numberOfLeaves << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
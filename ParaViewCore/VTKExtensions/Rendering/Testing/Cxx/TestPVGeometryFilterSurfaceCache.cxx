@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterSurfaceCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that vtkPVGeometryFilter reuses the surface of an unstructured grid
+// when only its attributes change, extracts it again when only its cells
+// change, and gives the same output as without the surface cache.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+bool SameArray(vtkDataArray* expected, vtkDataArray* actual)
+{
+  if (!expected || !actual || expected->GetNumberOfTuples() != actual->GetNumberOfTuples() ||
+    expected->GetNumberOfComponents() != actual->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < expected->GetNumberOfTuples(); cc++)
+  {
+    for (int comp = 0; comp < expected->GetNumberOfComponents(); comp++)
+    {
+      if (expected->GetComponent(cc, comp) != actual->GetComponent(cc, comp))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SameSurface(vtkPolyData* expected, vtkPolyData* actual, const char* step)
+{
+  if (expected->GetNumberOfPoints() != actual->GetNumberOfPoints() ||
+    expected->GetNumberOfCells() != actual->GetNumberOfCells() ||
+    !SameArray(expected->GetPoints()->GetData(), actual->GetPoints()->GetData()) ||
+    !SameArray(expected->GetPolys()->GetData(), actual->GetPolys()->GetData()))
+  {
+    cerr << "The cached surface differs " << step << "." << endl;
+    return false;
+  }
+  if (!SameArray(expected->GetPointData()->GetArray("PointValues"),
+        actual->GetPointData()->GetArray("PointValues")) ||
+    !SameArray(expected->GetCellData()->GetArray("CellValues"),
+      actual->GetCellData()->GetArray("CellValues")))
+  {
+    cerr << "The attributes of the cached surface differ " << step << "." << endl;
+    return false;
+  }
+  return true;
+}
+
+// Inserts a hexahedron whose first corner is the point (i, 0, 0) of a
+// 4x2x2 lattice.
+void InsertHexahedron(vtkCellArray* cells, int i)
+{
+  vtkIdType ids[8] = { i, i + 1, i + 5, i + 4, i + 8, i + 9, i + 13, i + 12 };
+  cells->InsertNextCell(8, ids);
+}
+}
+
+int TestPVGeometryFilterSurfaceCache(int, char* [])
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < 2; k++)
+  {
+    for (int j = 0; j < 2; j++)
+    {
+      for (int i = 0; i < 4; i++)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+
+  // Two hexahedra sharing a face.
+  vtkNew<vtkCellArray> cells;
+  InsertHexahedron(cells.GetPointer(), 0);
+  InsertHexahedron(cells.GetPointer(), 1);
+  int types[2] = { VTK_HEXAHEDRON, VTK_HEXAHEDRON };
+
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points.GetPointer());
+  grid->SetCells(types, cells.GetPointer());
+
+  vtkNew<vtkDoubleArray> pointValues;
+  pointValues->SetName("PointValues");
+  pointValues->SetNumberOfTuples(points->GetNumberOfPoints());
+  for (vtkIdType cc = 0; cc < points->GetNumberOfPoints(); cc++)
+  {
+    pointValues->SetValue(cc, cc);
+  }
+  grid->GetPointData()->AddArray(pointValues.GetPointer());
+  vtkNew<vtkDoubleArray> cellValues;
+  cellValues->SetName("CellValues");
+  cellValues->InsertNextValue(1);
+  cellValues->InsertNextValue(2);
+  grid->GetCellData()->AddArray(cellValues.GetPointer());
+
+  vtkNew<vtkPVGeometryFilter> cached;
+  cached->SetUseOutline(0);
+  cached->SetInputData(grid.GetPointer());
+  vtkNew<vtkPVGeometryFilter> reference;
+  reference->SetUseOutline(0);
+  reference->SetUseSurfaceCache(false);
+  reference->SetInputData(grid.GetPointer());
+
+  cached->Update();
+  reference->Update();
+  if (!SameSurface(reference->GetOutput(), cached->GetOutput(), "initially"))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkPoints* surfacePoints = cached->GetOutput()->GetPoints();
+
+  // Only the attributes change: the cached surface is used.
+  for (vtkIdType cc = 0; cc < points->GetNumberOfPoints(); cc++)
+  {
+    pointValues->SetValue(cc, 2.0 * cc + 1);
+  }
+  pointValues->Modified();
+  cellValues->SetValue(1, 5);
+  cellValues->Modified();
+  grid->Modified();
+  cached->Update();
+  reference->Update();
+  if (!SameSurface(reference->GetOutput(), cached->GetOutput(), "after changing attributes"))
+  {
+    return EXIT_FAILURE;
+  }
+  if (cached->GetOutput()->GetPoints() != surfacePoints)
+  {
+    cerr << "The surface was extracted again although only attributes changed." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Only the cells change: the second hexahedron is moved away from the
+  // first one, so that the surface has 12 faces instead of 10.
+  vtkNew<vtkCellArray> movedCells;
+  InsertHexahedron(movedCells.GetPointer(), 0);
+  InsertHexahedron(movedCells.GetPointer(), 2);
+  cells->DeepCopy(movedCells.GetPointer());
+  cells->Modified();
+  grid->Modified();
+  cached->Update();
+  reference->Update();
+  if (!SameSurface(reference->GetOutput(), cached->GetOutput(), "after changing cells"))
+  {
+    return EXIT_FAILURE;
+  }
+  if (cached->GetOutput()->GetNumberOfCells() != 12)
+  {
+    cerr << "Expected 12 faces after changing cells, got "
+         << cached->GetOutput()->GetNumberOfCells() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
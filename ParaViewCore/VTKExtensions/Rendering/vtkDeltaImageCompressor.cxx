@@ -0,0 +1,389 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkDeltaImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDeltaImageCompressor.h"
+
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkUnsignedCharArray.h"
+
+#include "vtk_lz4.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+// Compressed frame header, in 32-bit words.
+enum
+{
+  HEADER_MAGIC = 0,
+  HEADER_FRAME_TYPE,
+  HEADER_WIDTH,
+  HEADER_HEIGHT,
+  HEADER_COMPONENTS,
+  HEADER_TILE_SIZE,
+  HEADER_NUMBER_OF_TILES,
+  HEADER_PAYLOAD_SIZE,
+  HEADER_SIZE
+};
+
+const unsigned int vtkDeltaImageMagic = 0x31434944; // "DIC1"
+
+enum FrameTypes
+{
+  KEY_FRAME = 0,
+  DELTA_FRAME = 1
+};
+
+// Helper to iterate over the rows of a tile.
+struct vtkDeltaImageTile
+{
+  int X0, Y0, Width, Height;
+
+  vtkDeltaImageTile(int index, int tileSize, int imageWidth, int imageHeight)
+  {
+    const int tilesX = (imageWidth + tileSize - 1) / tileSize;
+    this->X0 = (index % tilesX) * tileSize;
+    this->Y0 = (index / tilesX) * tileSize;
+    this->Width = std::min(tileSize, imageWidth - this->X0);
+    this->Height = std::min(tileSize, imageHeight - this->Y0);
+  }
+
+  // Offset, in bytes, of the first pixel of `row` in the image.
+  size_t RowOffset(int row, int imageWidth, int numComps) const
+  {
+    return (static_cast<size_t>(this->Y0 + row) * imageWidth + this->X0) * numComps;
+  }
+};
+}
+
+vtkStandardNewMacro(vtkDeltaImageCompressor);
+//----------------------------------------------------------------------------
+vtkDeltaImageCompressor::vtkDeltaImageCompressor()
+  : KeyFrameInterval(30)
+  , TileSize(32)
+  , Width(0)
+  , Height(0)
+  , FramesSinceKeyFrame(-1)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkDeltaImageCompressor::~vtkDeltaImageCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::ResetKeyFrame()
+{
+  this->FramesSinceKeyFrame = -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::SetImageResolution(int width, int height)
+{
+  this->Width = width;
+  this->Height = height;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeltaImageCompressor::Compress()
+{
+  if (!(this->Input && this->Output))
+  {
+    vtkWarningMacro("Cannot compress, empty input or output detected.");
+    return VTK_ERROR;
+  }
+
+  vtkUnsignedCharArray* input = this->Input;
+  const int numComps = input->GetNumberOfComponents();
+  const vtkIdType numPixels = input->GetNumberOfTuples();
+  int width = this->Width;
+  int height = this->Height;
+  if (static_cast<vtkIdType>(width) * height != numPixels)
+  {
+    // Without a valid resolution we cannot build tiles; send the whole frame.
+    width = static_cast<int>(numPixels);
+    height = 1;
+    this->FramesSinceKeyFrame = -1;
+  }
+
+  const int tileSize = this->TileSize;
+  const int numTiles = ((width + tileSize - 1) / tileSize) * ((height + tileSize - 1) / tileSize);
+
+  bool keyFrame = this->FramesSinceKeyFrame < 0 ||
+    this->FramesSinceKeyFrame + 1 >= this->KeyFrameInterval ||
+    this->EncoderFrame->GetNumberOfComponents() != numComps ||
+    this->EncoderFrame->GetNumberOfTuples() != numPixels;
+
+  std::vector<unsigned int> changedTiles;
+  if (!keyFrame)
+  {
+    const unsigned char* current = input->GetPointer(0);
+    const unsigned char* previous = this->EncoderFrame->GetPointer(0);
+    for (int cc = 0; cc < numTiles; ++cc)
+    {
+      vtkDeltaImageTile tile(cc, tileSize, width, height);
+      const size_t rowBytes = static_cast<size_t>(tile.Width) * numComps;
+      for (int row = 0; row < tile.Height; ++row)
+      {
+        const size_t offset = tile.RowOffset(row, width, numComps);
+        if (memcmp(current + offset, previous + offset, rowBytes) != 0)
+        {
+          changedTiles.push_back(static_cast<unsigned int>(cc));
+          break;
+        }
+      }
+    }
+    // A key frame is cheaper to decode when most of the image changed.
+    keyFrame = (2 * changedTiles.size() > static_cast<size_t>(numTiles));
+  }
+
+  const unsigned char* payload = input->GetPointer(0);
+  size_t payloadSize = static_cast<size_t>(numPixels) * numComps;
+  if (!keyFrame)
+  {
+    // Payload is the list of changed tile indices followed by their pixels.
+    size_t tileBytes = 0;
+    for (size_t cc = 0; cc < changedTiles.size(); ++cc)
+    {
+      vtkDeltaImageTile tile(changedTiles[cc], tileSize, width, height);
+      tileBytes += static_cast<size_t>(tile.Width) * tile.Height * numComps;
+    }
+    payloadSize = changedTiles.size() * sizeof(unsigned int) + tileBytes;
+    this->Payload->SetNumberOfComponents(1);
+    unsigned char* ptr = this->Payload->WritePointer(0, static_cast<vtkIdType>(payloadSize));
+    if (!changedTiles.empty())
+    {
+      memcpy(ptr, &changedTiles[0], changedTiles.size() * sizeof(unsigned int));
+      ptr += changedTiles.size() * sizeof(unsigned int);
+    }
+    const unsigned char* current = input->GetPointer(0);
+    for (size_t cc = 0; cc < changedTiles.size(); ++cc)
+    {
+      vtkDeltaImageTile tile(changedTiles[cc], tileSize, width, height);
+      const size_t rowBytes = static_cast<size_t>(tile.Width) * numComps;
+      for (int row = 0; row < tile.Height; ++row)
+      {
+        memcpy(ptr, current + tile.RowOffset(row, width, numComps), rowBytes);
+        ptr += rowBytes;
+      }
+    }
+    payload = this->Payload->GetPointer(0);
+  }
+
+  const int maxCompressedSize = LZ4_compressBound(static_cast<int>(payloadSize));
+  const vtkIdType headerBytes = HEADER_SIZE * sizeof(unsigned int);
+  this->Output->SetNumberOfComponents(1);
+  unsigned char* out = this->Output->WritePointer(0, headerBytes + maxCompressedSize);
+
+  int compressedSize = 0;
+  if (payloadSize > 0)
+  {
+    compressedSize = LZ4_compress_fast(reinterpret_cast<const char*>(payload),
+      reinterpret_cast<char*>(out + headerBytes), static_cast<int>(payloadSize),
+      maxCompressedSize, 1);
+    if (compressedSize <= 0)
+    {
+      vtkErrorMacro("LZ4 compression failed.");
+      return VTK_ERROR;
+    }
+  }
+
+  unsigned int header[HEADER_SIZE];
+  header[HEADER_MAGIC] = vtkDeltaImageMagic;
+  header[HEADER_FRAME_TYPE] = keyFrame ? KEY_FRAME : DELTA_FRAME;
+  header[HEADER_WIDTH] = static_cast<unsigned int>(width);
+  header[HEADER_HEIGHT] = static_cast<unsigned int>(height);
+  header[HEADER_COMPONENTS] = static_cast<unsigned int>(numComps);
+  header[HEADER_TILE_SIZE] = static_cast<unsigned int>(tileSize);
+  header[HEADER_NUMBER_OF_TILES] = static_cast<unsigned int>(changedTiles.size());
+  header[HEADER_PAYLOAD_SIZE] = static_cast<unsigned int>(payloadSize);
+  memcpy(out, header, headerBytes);
+  this->Output->SetNumberOfTuples(headerBytes + compressedSize);
+
+  this->EncoderFrame->DeepCopy(input);
+  this->FramesSinceKeyFrame = keyFrame ? 0 : this->FramesSinceKeyFrame + 1;
+  return VTK_OK;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeltaImageCompressor::Decompress()
+{
+  if (!(this->Input && this->Output))
+  {
+    vtkWarningMacro("Cannot decompress, empty input or output detected.");
+    return VTK_ERROR;
+  }
+
+  const vtkIdType headerBytes = HEADER_SIZE * sizeof(unsigned int);
+  const vtkIdType inputSize =
+    this->Input->GetNumberOfTuples() * this->Input->GetNumberOfComponents();
+  unsigned int header[HEADER_SIZE];
+  if (inputSize < headerBytes)
+  {
+    vtkErrorMacro("Input is too small to be a compressed frame.");
+    return VTK_ERROR;
+  }
+  memcpy(header, this->Input->GetPointer(0), headerBytes);
+  if (header[HEADER_MAGIC] != vtkDeltaImageMagic)
+  {
+    vtkErrorMacro("Input was not compressed with vtkDeltaImageCompressor.");
+    return VTK_ERROR;
+  }
+
+  const int width = static_cast<int>(header[HEADER_WIDTH]);
+  const int height = static_cast<int>(header[HEADER_HEIGHT]);
+  const int numComps = static_cast<int>(header[HEADER_COMPONENTS]);
+  const int tileSize = static_cast<int>(header[HEADER_TILE_SIZE]);
+  const size_t numChangedTiles = header[HEADER_NUMBER_OF_TILES];
+  const size_t payloadSize = header[HEADER_PAYLOAD_SIZE];
+  const vtkIdType numPixels = static_cast<vtkIdType>(width) * height;
+  const size_t frameBytes = static_cast<size_t>(numPixels) * numComps;
+  vtkUnsignedCharArray* output = this->Output;
+  if (output->GetNumberOfComponents() != numComps || output->GetNumberOfTuples() != numPixels ||
+    tileSize <= 0)
+  {
+    vtkErrorMacro("Compressed frame does not match the output array.");
+    return VTK_ERROR;
+  }
+
+  this->Payload->SetNumberOfComponents(1);
+  unsigned char* payload = this->Payload->WritePointer(0, static_cast<vtkIdType>(payloadSize));
+  if (payloadSize > 0)
+  {
+    int decompressedSize =
+      LZ4_decompress_safe(reinterpret_cast<const char*>(this->Input->GetPointer(0) + headerBytes),
+        reinterpret_cast<char*>(payload), static_cast<int>(inputSize - headerBytes),
+        static_cast<int>(payloadSize));
+    if (decompressedSize < 0 || static_cast<size_t>(decompressedSize) != payloadSize)
+    {
+      vtkErrorMacro("LZ4 decompression failed.");
+      return VTK_ERROR;
+    }
+  }
+
+  unsigned char* out = output->GetPointer(0);
+  if (header[HEADER_FRAME_TYPE] == KEY_FRAME)
+  {
+    if (payloadSize != frameBytes)
+    {
+      vtkErrorMacro("Key frame has unexpected size.");
+      return VTK_ERROR;
+    }
+    memcpy(out, payload, frameBytes);
+  }
+  else
+  {
+    if (this->DecoderFrame->GetNumberOfComponents() != numComps ||
+      this->DecoderFrame->GetNumberOfTuples() != numPixels)
+    {
+      vtkErrorMacro("Received a delta frame without a matching previous frame.");
+      return VTK_ERROR;
+    }
+    if (numChangedTiles * sizeof(unsigned int) > payloadSize)
+    {
+      vtkErrorMacro("Delta frame is truncated.");
+      return VTK_ERROR;
+    }
+    memcpy(out, this->DecoderFrame->GetPointer(0), frameBytes);
+
+    const int numTiles =
+      ((width + tileSize - 1) / tileSize) * ((height + tileSize - 1) / tileSize);
+    const unsigned char* tileData = payload + numChangedTiles * sizeof(unsigned int);
+    const unsigned char* payloadEnd = payload + payloadSize;
+    for (size_t cc = 0; cc < numChangedTiles; ++cc)
+    {
+      unsigned int index;
+      memcpy(&index, payload + cc * sizeof(unsigned int), sizeof(unsigned int));
+      if (index >= static_cast<unsigned int>(numTiles))
+      {
+        vtkErrorMacro("Invalid tile index in delta frame.");
+        return VTK_ERROR;
+      }
+      vtkDeltaImageTile tile(index, tileSize, width, height);
+      const size_t rowBytes = static_cast<size_t>(tile.Width) * numComps;
+      if (tileData + rowBytes * tile.Height > payloadEnd)
+      {
+        vtkErrorMacro("Delta frame is truncated.");
+        return VTK_ERROR;
+      }
+      for (int row = 0; row < tile.Height; ++row)
+      {
+        memcpy(out + tile.RowOffset(row, width, numComps), tileData, rowBytes);
+        tileData += rowBytes;
+      }
+    }
+  }
+
+  this->DecoderFrame->DeepCopy(output);
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::SaveConfiguration(vtkMultiProcessStream* stream)
+{
+  this->Superclass::SaveConfiguration(stream);
+  *stream << this->KeyFrameInterval << this->TileSize;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDeltaImageCompressor::RestoreConfiguration(vtkMultiProcessStream* stream)
+{
+  if (this->Superclass::RestoreConfiguration(stream))
+  {
+    int interval, tileSize;
+    *stream >> interval >> tileSize;
+    this->SetKeyFrameInterval(interval);
+    this->SetTileSize(tileSize);
+    return true;
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkDeltaImageCompressor::SaveConfiguration()
+{
+  std::ostringstream oss;
+  oss << this->Superclass::SaveConfiguration() << " " << this->KeyFrameInterval << " "
+      << this->TileSize;
+  this->SetConfiguration(oss.str().c_str());
+  return this->Configuration;
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkDeltaImageCompressor::RestoreConfiguration(const char* stream)
+{
+  stream = this->Superclass::RestoreConfiguration(stream);
+  if (stream)
+  {
+    std::istringstream iss(stream);
+    int interval, tileSize;
+    iss >> interval >> tileSize;
+    this->SetKeyFrameInterval(interval);
+    this->SetTileSize(tileSize);
+    return stream + iss.tellg();
+  }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "KeyFrameInterval: " << this->KeyFrameInterval << endl;
+  os << indent << "TileSize: " << this->TileSize << endl;
+}
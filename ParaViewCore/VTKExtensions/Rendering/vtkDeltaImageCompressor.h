@@ -0,0 +1,126 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkDeltaImageCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkDeltaImageCompressor
+ * @brief   image compressor that only sends the tiles that changed since the
+ * previous frame.
+ *
+ * vtkDeltaImageCompressor keeps the previously compressed frame on the
+ * sending side and the previously decompressed frame on the receiving side.
+ * Each image is split into square tiles of TileSize pixels, and only tiles
+ * that differ from the previous frame are sent. The resulting payload is
+ * compressed losslessly using LZ4.
+ *
+ * A full key frame is sent for the first frame, whenever the image
+ * resolution or number of components changes, when more than half of the
+ * tiles changed, and at least every KeyFrameInterval frames.
+ *
+ * Since each frame depends on the previous one, every compressed frame must
+ * be decompressed by the receiving compressor, in order. Call
+ * ResetKeyFrame() to force the next frame to be a key frame, for example
+ * after the receiver was recreated.
+ *
+ * The image resolution must be provided using SetImageResolution() before
+ * compressing; otherwise every frame is sent as a key frame.
+*/
+
+#ifndef vtkDeltaImageCompressor_h
+#define vtkDeltaImageCompressor_h
+
+#include "vtkImageCompressor.h"
+#include "vtkNew.h"                            // needed for vtkNew
+#include "vtkPVVTKExtensionsRenderingModule.h" // needed for export macro
+
+class vtkMultiProcessStream;
+
+class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkDeltaImageCompressor : public vtkImageCompressor
+{
+public:
+  static vtkDeltaImageCompressor* New();
+  vtkTypeMacro(vtkDeltaImageCompressor, vtkImageCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Maximum number of frames between two key frames. Default is 30.
+   */
+  vtkSetClampMacro(KeyFrameInterval, int, 1, VTK_INT_MAX);
+  vtkGetMacro(KeyFrameInterval, int);
+  //@}
+
+  //@{
+  /**
+   * Width and height, in pixels, of the tiles that are compared against the
+   * previous frame. Default is 32.
+   */
+  vtkSetClampMacro(TileSize, int, 4, 1024);
+  vtkGetMacro(TileSize, int);
+  //@}
+
+  /**
+   * Forces the next compressed frame to be a key frame.
+   */
+  void ResetKeyFrame();
+
+  /**
+   * Communicates the next expected image resolution.
+   */
+  void SetImageResolution(int width, int height) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Compress/Decompress data array on the objects input with results
+   * in the objects output. See also Set/GetInput/Output.
+   */
+  int Compress() VTK_OVERRIDE;
+  int Decompress() VTK_OVERRIDE;
+  //@}
+
+  //@{
+  /**
+   * Serialize/Restore compressor configuration (but not the data) into the stream.
+   */
+  void SaveConfiguration(vtkMultiProcessStream* stream) VTK_OVERRIDE;
+  bool RestoreConfiguration(vtkMultiProcessStream* stream) VTK_OVERRIDE;
+  const char* SaveConfiguration() VTK_OVERRIDE;
+  const char* RestoreConfiguration(const char* stream) VTK_OVERRIDE;
+  //@}
+
+protected:
+  vtkDeltaImageCompressor();
+  ~vtkDeltaImageCompressor() override;
+
+  int KeyFrameInterval;
+  int TileSize;
+  int Width;
+  int Height;
+
+  // Number of frames compressed since the last key frame, or -1 to force a
+  // key frame.
+  int FramesSinceKeyFrame;
+
+private:
+  vtkDeltaImageCompressor(const vtkDeltaImageCompressor&) = delete;
+  void operator=(const vtkDeltaImageCompressor&) = delete;
+
+  // Last frame given to Compress().
+  vtkNew<vtkUnsignedCharArray> EncoderFrame;
+  // Last frame produced by Decompress().
+  vtkNew<vtkUnsignedCharArray> DecoderFrame;
+  // Uncompressed payload being built or decoded.
+  vtkNew<vtkUnsignedCharArray> Payload;
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include "vtkAMRInformation.h"
 #include "vtkAlgorithmOutput.h"
 #include "vtkAppendPolyData.h"
+#include "vtkAtomic.h"
 #include "vtkCallbackCommand.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
@@ -38,6 +39,7 @@
 #include "vtkHyperOctreeSurfaceFilter.h"
 #include "vtkHyperTreeGrid.h"
 #include "vtkHyperTreeGridGeometry.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationIntegerVectorKey.h"
@@ -46,16 +48,20 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiPieceDataSet.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineSource.h"
 #include "vtkPVRecoverGeometryWireframe.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridOutlineFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSelectionNode.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -135,6 +141,217 @@ public:
   int Commutative() override { return 1; }
 };
 
+//----------------------------------------------------------------------------
+// Surface extracted from an unstructured grid along with the state of the
+// input it depends on. As long as the points, the cells, the polyhedral faces
+// and the ghost arrays of the input are the same, the surface only needs new attributes, which are
+// gathered through its vtkOriginalPointIds and vtkOriginalCellIds arrays.
+class vtkPVGeometryFilter::SurfaceCacheEntry
+{
+public:
+  SurfaceCacheEntry()
+    : Used(false)
+  {
+  }
+
+  bool IsValid(vtkUnstructuredGrid* input) const
+  {
+    return this->Surface.GetPointer() != NULL && this->State == InputState(input);
+  }
+
+  // Keeps the topology of surface and its original id arrays. Returns false if
+  // the surface cannot be reused later.
+  bool Store(vtkUnstructuredGrid* input, vtkPolyData* surface)
+  {
+    this->Surface = NULL;
+    vtkIdTypeArray* pointIds =
+      vtkIdTypeArray::SafeDownCast(surface->GetPointData()->GetArray("vtkOriginalPointIds"));
+    vtkIdTypeArray* cellIds =
+      vtkIdTypeArray::SafeDownCast(surface->GetCellData()->GetArray("vtkOriginalCellIds"));
+    if (!pointIds || !cellIds)
+    {
+      return false;
+    }
+
+    this->Surface = vtkSmartPointer<vtkPolyData>::New();
+    this->Surface->CopyStructure(surface);
+    this->Surface->GetPointData()->AddArray(pointIds);
+    this->Surface->GetCellData()->AddArray(cellIds);
+    this->State = InputState(input);
+    return true;
+  }
+
+  void Restore(vtkUnstructuredGrid* input, vtkPolyData* output)
+  {
+    vtkIdTypeArray* pointIds = vtkIdTypeArray::SafeDownCast(
+      this->Surface->GetPointData()->GetArray("vtkOriginalPointIds"));
+    vtkIdTypeArray* cellIds =
+      vtkIdTypeArray::SafeDownCast(this->Surface->GetCellData()->GetArray("vtkOriginalCellIds"));
+    output->CopyStructure(this->Surface);
+
+    vtkPointData* inPD = input->GetPointData();
+    vtkPointData* outPD = output->GetPointData();
+    vtkIdType numPts = pointIds->GetNumberOfTuples();
+    outPD->CopyGlobalIdsOn();
+    outPD->CopyAllocate(inPD, numPts);
+    for (vtkIdType cc = 0; cc < numPts; ++cc)
+    {
+      outPD->CopyData(inPD, pointIds->GetValue(cc), cc);
+    }
+    outPD->AddArray(pointIds);
+
+    vtkCellData* inCD = input->GetCellData();
+    vtkCellData* outCD = output->GetCellData();
+    vtkIdType numCells = cellIds->GetNumberOfTuples();
+    outCD->CopyGlobalIdsOn();
+    outCD->CopyAllocate(inCD, numCells);
+    for (vtkIdType cc = 0; cc < numCells; ++cc)
+    {
+      outCD->CopyData(inCD, cellIds->GetValue(cc), cc);
+    }
+    outCD->AddArray(cellIds);
+  }
+
+  bool HasSurface() const { return this->Surface.GetPointer() != NULL; }
+
+  bool Used;
+
+private:
+  // What the surface depends on. Pointers are only compared, never
+  // dereferenced.
+  struct InputState
+  {
+    InputState()
+      : Input(NULL)
+      , Points(NULL)
+      , Cells(NULL)
+      , PointGhosts(NULL)
+      , CellGhosts(NULL)
+      , Faces(NULL)
+      , FaceLocations(NULL)
+      , TopologyMTime(0)
+    {
+    }
+
+    explicit InputState(vtkUnstructuredGrid* input)
+      : Input(input)
+      , Points(input->GetPoints())
+      , Cells(input->GetCells())
+      , PointGhosts(input->GetPointData()->GetArray(vtkDataSetAttributes::GhostArrayName()))
+      , CellGhosts(input->GetCellData()->GetArray(vtkDataSetAttributes::GhostArrayName()))
+      , Faces(input->GetFaces())
+      , FaceLocations(input->GetFaceLocations())
+      , TopologyMTime(0)
+    {
+      if (this->Points)
+      {
+        this->TopologyMTime = this->Points->GetMTime();
+      }
+      if (this->Cells)
+      {
+        this->TopologyMTime = std::max(this->TopologyMTime, this->Cells->GetMTime());
+        this->TopologyMTime = std::max(this->TopologyMTime, this->Cells->GetData()->GetMTime());
+      }
+      if (vtkUnsignedCharArray* types = input->GetCellTypesArray())
+      {
+        this->TopologyMTime = std::max(this->TopologyMTime, types->GetMTime());
+      }
+      if (this->PointGhosts)
+      {
+        this->TopologyMTime = std::max(this->TopologyMTime, this->PointGhosts->GetMTime());
+      }
+      if (this->CellGhosts)
+      {
+        this->TopologyMTime = std::max(this->TopologyMTime, this->CellGhosts->GetMTime());
+      }
+      if (this->Faces)
+      {
+        this->TopologyMTime = std::max(this->TopologyMTime, this->Faces->GetMTime());
+      }
+      if (this->FaceLocations)
+      {
+        this->TopologyMTime = std::max(this->TopologyMTime, this->FaceLocations->GetMTime());
+      }
+    }
+
+    bool operator==(const InputState& other) const
+    {
+      return this->Input == other.Input && this->Points == other.Points &&
+        this->Cells == other.Cells && this->PointGhosts == other.PointGhosts &&
+        this->CellGhosts == other.CellGhosts && this->Faces == other.Faces &&
+        this->FaceLocations == other.FaceLocations && this->TopologyMTime == other.TopologyMTime;
+    }
+
+    vtkUnstructuredGrid* Input;
+    vtkPoints* Points;
+    vtkCellArray* Cells;
+    vtkDataArray* PointGhosts;
+    vtkDataArray* CellGhosts;
+    vtkIdTypeArray* Faces;
+    vtkIdTypeArray* FaceLocations;
+    vtkMTimeType TopologyMTime;
+  };
+
+  vtkSmartPointer<vtkPolyData> Surface;
+  InputState State;
+};
+
+//----------------------------------------------------------------------------
+// All cached surfaces of the filter. Entries are only created or removed
+// between BeginUpdate() and EndUpdate() on the thread executing the filter, so
+// they can be handed to the threads extracting surfaces of composite leaves.
+class vtkPVGeometryFilter::SurfaceCacheMap
+{
+public:
+  SurfaceCacheMap()
+    : FilterMTime(0)
+  {
+  }
+
+  // Changing any property of the filter invalidates every surface.
+  void BeginUpdate(vtkMTimeType filterMTime)
+  {
+    if (filterMTime != this->FilterMTime)
+    {
+      this->Entries.clear();
+      this->FilterMTime = filterMTime;
+    }
+    std::map<unsigned int, SurfaceCacheEntry>::iterator iter;
+    for (iter = this->Entries.begin(); iter != this->Entries.end(); ++iter)
+    {
+      iter->second.Used = false;
+    }
+  }
+
+  SurfaceCacheEntry* GetEntry(unsigned int index)
+  {
+    SurfaceCacheEntry* entry = &this->Entries[index];
+    entry->Used = true;
+    return entry;
+  }
+
+  // Drops the surfaces of blocks that are not part of the input anymore.
+  void EndUpdate()
+  {
+    std::map<unsigned int, SurfaceCacheEntry>::iterator iter = this->Entries.begin();
+    while (iter != this->Entries.end())
+    {
+      if (iter->second.Used && iter->second.HasSurface())
+      {
+        ++iter;
+      }
+      else
+      {
+        this->Entries.erase(iter++);
+      }
+    }
+  }
+
+private:
+  std::map<unsigned int, SurfaceCacheEntry> Entries;
+  vtkMTimeType FilterMTime;
+};
+
 //----------------------------------------------------------------------------
 vtkPVGeometryFilter::vtkPVGeometryFilter()
 {
@@ -178,6 +395,10 @@ vtkPVGeometryFilter::vtkPVGeometryFilter()
 
   this->HideInternalAMRFaces = true;
   this->UseNonOverlappingAMRMetaDataForOutlines = true;
+  this->UseSurfaceCache = true;
+
+  this->SurfaceCaches = new SurfaceCacheMap();
+  this->CurrentSurfaceCache = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -211,6 +432,7 @@ vtkPVGeometryFilter::~vtkPVGeometryFilter()
   }
   this->OutlineSource->Delete();
   this->SetController(0);
+  delete this->SurfaceCaches;
 }
 
 //----------------------------------------------------------------------------
@@ -557,7 +779,11 @@ int vtkPVGeometryFilter::RequestData(
   }
   int* wholeExtent =
     vtkStreamingDemandDrivenPipeline::GetWholeExtent(inputVector[0]->GetInformationObject(0));
+  this->SurfaceCaches->BeginUpdate(this->GetMTime());
+  this->CurrentSurfaceCache = this->UseSurfaceCache ? this->SurfaceCaches->GetEntry(0) : NULL;
   this->ExecuteBlock(input, output, 1, procid, numProcs, 0, wholeExtent);
+  this->CurrentSurfaceCache = NULL;
+  this->SurfaceCaches->EndUpdate();
   this->CleanupOutputData(output, 1);
   return 1;
 }
@@ -877,6 +1103,96 @@ int vtkPVGeometryFilter::RequestAMRData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Extracts the surfaces of composite dataset leaves in parallel. The internal
+// filters used by ExecuteBlock() are not reentrant, so every thread works with
+// its own instance of the geometry filter. Progress is only reported from the
+// thread that executes the filter so that observers are never invoked
+// concurrently.
+class vtkPVGeometryFilter::CompositeBlocksWorker
+{
+public:
+  struct Block
+  {
+    vtkDataObject* Input;
+    vtkSmartPointer<vtkPolyData> Output;
+    int OutlineFlag;
+    SurfaceCacheEntry* SurfaceCache;
+  };
+
+  CompositeBlocksWorker(vtkPVGeometryFilter* self, std::vector<Block>& blocks, const int* ext)
+    : Self(self)
+    , Blocks(blocks)
+    , Indices(NULL)
+    , WholeExtent(ext)
+    , NumberOfBlocksDone(0)
+  {
+    this->MainThreadId = vtkMultiThreader::GetCurrentThreadID();
+  }
+
+  /**
+   * Extracts the surfaces of the blocks at the given indices, concurrently
+   * when \c parallel is true and in the calling thread otherwise.
+   */
+  void Execute(const std::vector<size_t>& indices, bool parallel)
+  {
+    this->Indices = &indices;
+    if (parallel)
+    {
+      vtkSMPTools::For(0, static_cast<vtkIdType>(indices.size()), 1, *this);
+    }
+    else
+    {
+      this->Initialize();
+      (*this)(0, static_cast<vtkIdType>(indices.size()));
+    }
+    this->Indices = NULL;
+  }
+
+  void Initialize()
+  {
+    vtkSmartPointer<vtkPVGeometryFilter>& filter = this->Filters.Local();
+    if (!filter)
+    {
+      filter.TakeReference(this->Self->NewInstance());
+      filter->CopyBlockExecuteSettings(this->Self);
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkPVGeometryFilter* filter = this->Filters.Local();
+    for (vtkIdType cc = begin; cc < end && !this->Self->GetAbortExecute(); ++cc)
+    {
+      Block& block = this->Blocks[(*this->Indices)[cc]];
+      block.Output = vtkSmartPointer<vtkPolyData>::New();
+      filter->CurrentSurfaceCache = block.SurfaceCache;
+      filter->ExecuteBlock(block.Input, block.Output, 0, 0, 1, 0, this->WholeExtent);
+      filter->CurrentSurfaceCache = NULL;
+      filter->CleanupOutputData(block.Output, 0);
+      block.OutlineFlag = filter->OutlineFlag;
+
+      int done = ++this->NumberOfBlocksDone;
+      vtkMultiThreaderIDType threadId = vtkMultiThreader::GetCurrentThreadID();
+      if (vtkMultiThreader::ThreadsEqual(this->MainThreadId, threadId))
+      {
+        this->Self->UpdateProgress(static_cast<double>(done) / this->Blocks.size());
+      }
+    }
+  }
+
+  void Reduce() {}
+
+private:
+  vtkPVGeometryFilter* Self;
+  std::vector<Block>& Blocks;
+  const std::vector<size_t>* Indices;
+  const int* WholeExtent;
+  vtkAtomic<int> NumberOfBlocksDone;
+  vtkMultiThreaderIDType MainThreadId;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkPVGeometryFilter> > Filters;
+};
+
 //----------------------------------------------------------------------------
 int vtkPVGeometryFilter::RequestCompositeData(
   vtkInformation*, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
@@ -907,54 +1223,92 @@ int vtkPVGeometryFilter::RequestCompositeData(
   vtkSmartPointer<vtkCompositeDataIterator> iter;
   iter.TakeReference(input->NewIterator());
 
-  unsigned int totNumBlocks = 0;
+  std::vector<CompositeBlocksWorker::Block> blocks;
+  this->SurfaceCaches->BeginUpdate(this->GetMTime());
   for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
   {
     // iter skips empty blocks automatically.
-    totNumBlocks++;
+    CompositeBlocksWorker::Block item;
+    item.Input = iter->GetCurrentDataObject();
+    item.OutlineFlag = 0;
+    item.SurfaceCache =
+      this->UseSurfaceCache ? this->SurfaceCaches->GetEntry(iter->GetCurrentFlatIndex()) : NULL;
+    blocks.push_back(item);
+  }
+
+  // Leaves whose dataset or points are also used by another leaf are not
+  // processed concurrently: reading a dataset can build its cells, links or
+  // bounds on demand, which is not thread safe.
+  std::map<vtkObject*, int> useCounts;
+  for (size_t cc = 0; cc < blocks.size(); ++cc)
+  {
+    ++useCounts[blocks[cc].Input];
+    if (vtkPointSet* ps = vtkPointSet::SafeDownCast(blocks[cc].Input))
+    {
+      if (ps->GetPoints())
+      {
+        ++useCounts[ps->GetPoints()];
+      }
+    }
+  }
+  std::vector<size_t> independentBlocks;
+  std::vector<size_t> sharedBlocks;
+  for (size_t cc = 0; cc < blocks.size(); ++cc)
+  {
+    vtkPointSet* ps = vtkPointSet::SafeDownCast(blocks[cc].Input);
+    if (useCounts[blocks[cc].Input] > 1 ||
+      (ps && ps->GetPoints() && useCounts[ps->GetPoints()] > 1))
+    {
+      sharedBlocks.push_back(cc);
+    }
+    else
+    {
+      independentBlocks.push_back(cc);
+    }
   }
 
-  std::vector<unsigned char> non_null_leaves;
-  non_null_leaves.reserve(totNumBlocks); // just an estimate.
+  // Independent leaves are extracted concurrently, the others one at a time.
   int* wholeExtent =
     vtkStreamingDemandDrivenPipeline::GetWholeExtent(inputVector[0]->GetInformationObject(0));
-  int numInputs = 0;
+  CompositeBlocksWorker worker(this, blocks, wholeExtent);
+  worker.Execute(independentBlocks, true);
+  worker.Execute(sharedBlocks, false);
+  this->SurfaceCaches->EndUpdate();
+  if (!blocks.empty())
+  {
+    this->OutlineFlag = blocks.back().OutlineFlag;
+  }
+
+  // Results are attached in traversal order so that the output and its
+  // annotations do not depend on how the leaves were scheduled.
+  std::vector<unsigned char> non_null_leaves;
+  non_null_leaves.reserve(blocks.size()); // just an estimate.
+  size_t next_block = 0;
 
   unsigned int block_id = 0;
   iter->SkipEmptyNodesOff(); // since we want to a get an accurate block-id count to
                              // set vtkBlockColors correctly.
   for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), ++block_id)
   {
-    vtkDataObject* block = iter->GetCurrentDataObject();
-    if (!block)
+    if (!iter->GetCurrentDataObject())
     {
       continue;
     }
 
-    vtkPolyData* tmpOut = vtkPolyData::New();
-    this->ExecuteBlock(block, tmpOut, 0, 0, 1, 0, wholeExtent);
-    this->CleanupOutputData(tmpOut, 0);
+    vtkPolyData* tmpOut = blocks[next_block++].Output;
     // skip empty nodes.
-    if (tmpOut->GetNumberOfPoints() > 0)
+    if (tmpOut && tmpOut->GetNumberOfPoints() > 0)
     {
       unsigned int current_flat_index = iter->GetCurrentFlatIndex();
       non_null_leaves.resize(current_flat_index + 1);
       non_null_leaves[current_flat_index] = 1;
       output->SetDataSet(iter, tmpOut);
-      tmpOut->FastDelete();
 
       this->AddCompositeIndex(tmpOut, current_flat_index);
       this->AddBlockColors(tmpOut, block_id);
     }
-    else
-    {
-      tmpOut->Delete();
-      tmpOut = NULL;
-    }
-
-    numInputs++;
-    this->UpdateProgress(static_cast<float>(numInputs) / totNumBlocks);
   }
+  blocks.clear();
   vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::ExecuteCompositeDataSet");
 
   // Merge multi-pieces to avoid efficiency setbacks when ordered
@@ -1369,6 +1723,16 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
   {
     this->OutlineFlag = 0;
 
+    // When only the attributes changed since the surface of this block was
+    // last extracted, gather them through the cached original ids instead.
+    vtkUnstructuredGrid* cacheInput = vtkUnstructuredGrid::SafeDownCast(input);
+    SurfaceCacheEntry* cache = cacheInput ? this->CurrentSurfaceCache : NULL;
+    if (cache && cache->IsValid(cacheInput))
+    {
+      cache->Restore(cacheInput, output);
+      return;
+    }
+
     bool handleSubdivision = (this->Triangulate != 0) && (input->GetNumberOfCells() > 0);
     if (!handleSubdivision && (this->NonlinearSubdivisionLevel > 0))
     {
@@ -1517,6 +1881,13 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
     }
 
     output->GetCellData()->RemoveArray(vtkPVRecoverGeometryWireframe::ORIGINAL_FACE_IDS());
+
+    // Subdivided surfaces have interpolated points, so their attributes cannot
+    // be gathered through the original ids.
+    if (cache && !handleSubdivision)
+    {
+      cache->Store(cacheInput, output);
+    }
     return;
   }
 
@@ -1715,6 +2086,7 @@ void vtkPVGeometryFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "PassThroughCellIds: " << (this->PassThroughCellIds ? "On\n" : "Off\n");
   os << indent << "PassThroughPointIds: " << (this->PassThroughPointIds ? "On\n" : "Off\n");
+  os << indent << "UseSurfaceCache: " << (this->UseSurfaceCache ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
@@ -1785,6 +2157,26 @@ void vtkPVGeometryFilter::SetUseStrips(int newvalue)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVGeometryFilter::CopyBlockExecuteSettings(vtkPVGeometryFilter* other)
+{
+  this->SetController(other->Controller);
+  this->SetUseOutline(other->UseOutline);
+  this->SetBlockColorsDistinctValues(other->BlockColorsDistinctValues);
+  this->SetForceUseStrips(other->ForceUseStrips);
+  this->SetUseStrips(other->UseStrips);
+  this->SetGenerateCellNormals(other->GenerateCellNormals);
+  this->SetTriangulate(other->Triangulate);
+  this->SetNonlinearSubdivisionLevel(other->NonlinearSubdivisionLevel);
+  this->SetPassThroughCellIds(other->PassThroughCellIds);
+  this->SetPassThroughPointIds(other->PassThroughPointIds);
+  this->SetGenerateProcessIds(other->GenerateProcessIds);
+  this->SetHideInternalAMRFaces(other->HideInternalAMRFaces);
+  this->SetUseNonOverlappingAMRMetaDataForOutlines(
+    other->UseNonOverlappingAMRMetaDataForOutlines);
+  this->SetUseSurfaceCache(other->UseSurfaceCache);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeometryFilter::RemoveGhostCells(vtkPolyData* output)
 {
@@ -197,6 +197,17 @@ public:
   vtkBooleanMacro(UseNonOverlappingAMRMetaDataForOutlines, bool);
   //@}
 
+  //@{
+  /**
+   * When set to true (default), the surfaces extracted from unstructured grids
+   * are kept, and reused as long as only the attributes of the input change.
+   * Set to false to save the memory of the cached surfaces.
+   */
+  vtkSetMacro(UseSurfaceCache, bool);
+  vtkGetMacro(UseSurfaceCache, bool);
+  vtkBooleanMacro(UseSurfaceCache, bool);
+  //@}
+
   // These keys are put in the output composite-data metadata for multipieces
   // since this filter merges multipieces together.
   static vtkInformationIntegerVectorKey* POINT_OFFSETS();
@@ -274,6 +285,14 @@ protected:
 
   void ChangeUseStripsInternal(int val, int force);
 
+  /**
+   * Copies the settings that affect ExecuteBlock() and CleanupOutputData()
+   * from \c other. Used to set up the per-thread instances that extract the
+   * surfaces of composite dataset leaves concurrently, so properties added to
+   * this class must be copied here as well.
+   */
+  void CopyBlockExecuteSettings(vtkPVGeometryFilter* other);
+
   int OutlineFlag;
   int UseOutline;
   int BlockColorsDistinctValues;
@@ -320,6 +339,20 @@ protected:
   int StripModFirstPass;
   bool HideInternalAMRFaces;
   bool UseNonOverlappingAMRMetaDataForOutlines;
+  bool UseSurfaceCache;
+
+  /**
+   * Surfaces extracted from unstructured grid blocks are cached, keyed on the
+   * flat index of the block (0 for non-composite inputs). When only the
+   * attributes of a block change, UnstructuredGridExecute() gathers them
+   * through the original point and cell ids of the cached surface instead of
+   * extracting the surface again. CurrentSurfaceCache is the entry for the
+   * block being executed, if any.
+   */
+  class SurfaceCacheEntry;
+  class SurfaceCacheMap;
+  SurfaceCacheMap* SurfaceCaches;
+  SurfaceCacheEntry* CurrentSurfaceCache;
 
 private:
   vtkPVGeometryFilter(const vtkPVGeometryFilter&) = delete;
@@ -336,6 +369,7 @@ private:
   void AddBlockColors(vtkPolyData* pd, unsigned int index);
   void AddHierarchicalIndex(vtkPolyData* pd, unsigned int level, unsigned int index);
   class BoundsReductionOperation;
+  class CompositeBlocksWorker;
   //@}
 };
 
@@ -0,0 +1,394 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTiledSquirtCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTiledSquirtCompressor.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// Stream layout, in 32-bit words:
+//   magic, number of components, number of pixels, tile size, number of tiles,
+//   number of encoded words for each tile, encoded tiles back to back.
+const unsigned int vtkTiledSquirtMagic = 0x31515354; // "TSQ1"
+const vtkIdType vtkTiledSquirtHeaderWords = 5;
+
+// Maximum run encoded in a single RGBA word (4 bits are used for opacity).
+const int vtkTiledSquirtMaxRunRGBA = 0x0F;
+// Maximum run encoded in a single RGB word.
+const int vtkTiledSquirtMaxRunRGB = 0xFF;
+
+// Returns the number of pixels at the start of `pixels` that are equal to
+// `maskedColor` under `mask`, but at most `available`. Full windows are
+// checked with a fixed-length loop without early exit so that the compiler
+// can turn the comparisons into SIMD instructions.
+inline int vtkTiledSquirtRunLength(
+  const unsigned int* pixels, vtkIdType available, unsigned int maskedColor, unsigned int mask)
+{
+  if (available >= vtkTiledSquirtMaxRunRGBA)
+  {
+    unsigned int mismatches = 1u << vtkTiledSquirtMaxRunRGBA;
+    for (int cc = 0; cc < vtkTiledSquirtMaxRunRGBA; ++cc)
+    {
+      mismatches |= static_cast<unsigned int>((pixels[cc] & mask) != maskedColor) << cc;
+    }
+    int run = 0;
+    while ((mismatches & 0x1) == 0)
+    {
+      mismatches >>= 1;
+      ++run;
+    }
+    return run;
+  }
+
+  int run = 0;
+  while (run < available && (pixels[run] & mask) == maskedColor)
+  {
+    ++run;
+  }
+  return run;
+}
+
+// Encodes `numPixels` RGBA pixels. Returns the number of words written.
+vtkIdType vtkTiledSquirtEncodeRGBA(
+  const unsigned int* in, vtkIdType numPixels, unsigned int mask, unsigned int* out)
+{
+  vtkIdType index = 0;
+  vtkIdType outIndex = 0;
+  while (index < numPixels)
+  {
+    const unsigned int color = in[index++];
+    int count = vtkTiledSquirtRunLength(in + index, numPixels - index, color & mask, mask);
+    index += count;
+
+    unsigned char opacity = *(reinterpret_cast<const unsigned char*>(&color) + 3);
+    if (opacity > 0)
+    {
+      // encode 8-bit opacity into 4 bits.
+      count |= (opacity / 16) << 4;
+    }
+    out[outIndex] = color;
+    *(reinterpret_cast<unsigned char*>(out + outIndex) + 3) = static_cast<unsigned char>(count);
+    ++outIndex;
+  }
+  return outIndex;
+}
+
+// Encodes `numPixels` RGB pixels. Returns the number of words written.
+vtkIdType vtkTiledSquirtEncodeRGB(
+  const unsigned char* in, vtkIdType numPixels, unsigned int mask, unsigned int* out)
+{
+  vtkIdType index = 0;
+  vtkIdType outIndex = 0;
+  while (index < numPixels)
+  {
+    unsigned int color = 0;
+    memcpy(&color, in + 3 * index, 3);
+    ++index;
+
+    int count = 0;
+    while (index < numPixels && count < vtkTiledSquirtMaxRunRGB)
+    {
+      unsigned int next = 0;
+      memcpy(&next, in + 3 * index, 3);
+      if ((next & mask) != (color & mask))
+      {
+        break;
+      }
+      ++index;
+      ++count;
+    }
+
+    out[outIndex] = color;
+    *(reinterpret_cast<unsigned char*>(out + outIndex) + 3) = static_cast<unsigned char>(count);
+    ++outIndex;
+  }
+  return outIndex;
+}
+
+// Decodes `numWords` words into at most `numPixels` RGBA pixels. Returns
+// false if the encoded data does not match the expected number of pixels.
+bool vtkTiledSquirtDecodeRGBA(
+  const unsigned int* in, vtkIdType numWords, unsigned int* out, vtkIdType numPixels)
+{
+  vtkIdType index = 0;
+  for (vtkIdType cc = 0; cc < numWords; ++cc)
+  {
+    unsigned int color = in[cc];
+    int count = *(reinterpret_cast<const unsigned char*>(&color) + 3);
+    unsigned char opacity = static_cast<unsigned char>(((count & 0xF0) >> 4) * 16);
+    *(reinterpret_cast<unsigned char*>(&color) + 3) = opacity;
+    count &= 0x0F;
+    if (index + count + 1 > numPixels)
+    {
+      return false;
+    }
+    std::fill(out + index, out + index + count + 1, color);
+    index += count + 1;
+  }
+  return index == numPixels;
+}
+
+// Decodes `numWords` words into at most `numPixels` RGB pixels.
+bool vtkTiledSquirtDecodeRGB(
+  const unsigned int* in, vtkIdType numWords, unsigned char* out, vtkIdType numPixels)
+{
+  vtkIdType index = 0;
+  for (vtkIdType cc = 0; cc < numWords; ++cc)
+  {
+    const unsigned char* color = reinterpret_cast<const unsigned char*>(in + cc);
+    int count = color[3];
+    if (index + count + 1 > numPixels)
+    {
+      return false;
+    }
+    for (int run = 0; run <= count; ++run, ++index)
+    {
+      memcpy(out + 3 * index, color, 3);
+    }
+  }
+  return index == numPixels;
+}
+
+class vtkTiledSquirtEncodeFunctor
+{
+public:
+  const unsigned char* Input;
+  int NumberOfComponents;
+  vtkIdType NumberOfPixels;
+  vtkIdType TileSize;
+  unsigned int Mask;
+  unsigned int* Output; // start of the encoded region, one TileSize slot per tile.
+  std::vector<vtkIdType>* EncodedSizes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      const vtkIdType start = tile * this->TileSize;
+      const vtkIdType count = std::min(this->TileSize, this->NumberOfPixels - start);
+      unsigned int* out = this->Output + start;
+      if (this->NumberOfComponents == 4)
+      {
+        const unsigned int* in = reinterpret_cast<const unsigned int*>(this->Input) + start;
+        (*this->EncodedSizes)[tile] = vtkTiledSquirtEncodeRGBA(in, count, this->Mask, out);
+      }
+      else
+      {
+        const unsigned char* in = this->Input + 3 * start;
+        (*this->EncodedSizes)[tile] = vtkTiledSquirtEncodeRGB(in, count, this->Mask, out);
+      }
+    }
+  }
+};
+
+class vtkTiledSquirtDecodeFunctor
+{
+public:
+  const unsigned int* Input; // start of the encoded tiles.
+  const std::vector<vtkIdType>* Offsets;
+  int NumberOfComponents;
+  vtkIdType NumberOfPixels;
+  vtkIdType TileSize;
+  unsigned char* Output;
+  std::vector<unsigned char>* Status;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      const vtkIdType start = tile * this->TileSize;
+      const vtkIdType count = std::min(this->TileSize, this->NumberOfPixels - start);
+      const unsigned int* in = this->Input + (*this->Offsets)[tile];
+      const vtkIdType numWords = (*this->Offsets)[tile + 1] - (*this->Offsets)[tile];
+      bool status;
+      if (this->NumberOfComponents == 4)
+      {
+        unsigned int* out = reinterpret_cast<unsigned int*>(this->Output) + start;
+        status = vtkTiledSquirtDecodeRGBA(in, numWords, out, count);
+      }
+      else
+      {
+        status = vtkTiledSquirtDecodeRGB(in, numWords, this->Output + 3 * start, count);
+      }
+      (*this->Status)[tile] = status ? 1 : 0;
+    }
+  }
+};
+}
+
+vtkStandardNewMacro(vtkTiledSquirtCompressor);
+
+//-----------------------------------------------------------------------------
+vtkTiledSquirtCompressor::vtkTiledSquirtCompressor()
+  : TileSize(65536)
+{
+}
+
+//-----------------------------------------------------------------------------
+vtkTiledSquirtCompressor::~vtkTiledSquirtCompressor()
+{
+}
+
+//-----------------------------------------------------------------------------
+int vtkTiledSquirtCompressor::Compress()
+{
+  if (!(this->Input && this->Output))
+  {
+    vtkWarningMacro("Cannot compress empty input or output detected.");
+    return VTK_ERROR;
+  }
+
+  vtkUnsignedCharArray* input = this->GetInput();
+  const int numComps = input->GetNumberOfComponents();
+  if (numComps != 4 && numComps != 3)
+  {
+    vtkErrorMacro("Squirt only works with RGBA or RGB");
+    return VTK_ERROR;
+  }
+
+  unsigned char compress_masks[6][4] = { { 0xFF, 0xFF, 0xFF, 0xFF }, { 0xFE, 0xFF, 0xFE, 0xFE },
+    { 0xFC, 0xFE, 0xFC, 0xFC }, { 0xF8, 0xFC, 0xF8, 0xF8 }, { 0xF0, 0xF8, 0xF0, 0xF0 },
+    { 0xE0, 0xF0, 0xE0, 0xE0 } };
+  int compress_level = this->LossLessMode ? 0 : this->SquirtLevel;
+  if (compress_level < 0 || compress_level > 5)
+  {
+    vtkErrorMacro("Squirt compression level (" << compress_level << ") is out of range [0,5].");
+    return VTK_ERROR;
+  }
+  unsigned int compress_mask;
+  memcpy(&compress_mask, &compress_masks[compress_level], 4);
+  if (numComps == 3)
+  {
+    // the fourth byte holds the run length and is never compared.
+    reinterpret_cast<unsigned char*>(&compress_mask)[3] = 0;
+  }
+
+  const vtkIdType numPixels = input->GetNumberOfTuples();
+  const vtkIdType tileSize = this->TileSize;
+  const vtkIdType numTiles = (numPixels + tileSize - 1) / tileSize;
+  const vtkIdType headerWords = vtkTiledSquirtHeaderWords + numTiles;
+
+  // Every pixel encodes to at most one word, so each tile gets a slot of
+  // TileSize words to encode into independently. The slots are packed once
+  // all tiles are done.
+  this->Output->SetNumberOfComponents(1);
+  unsigned int* out =
+    reinterpret_cast<unsigned int*>(this->Output->WritePointer(0, 4 * (headerWords + numPixels)));
+
+  std::vector<vtkIdType> encodedSizes(numTiles, 0);
+  vtkTiledSquirtEncodeFunctor functor;
+  functor.Input = input->GetPointer(0);
+  functor.NumberOfComponents = numComps;
+  functor.NumberOfPixels = numPixels;
+  functor.TileSize = tileSize;
+  functor.Mask = compress_mask;
+  functor.Output = out + headerWords;
+  functor.EncodedSizes = &encodedSizes;
+  vtkSMPTools::For(0, numTiles, 1, functor);
+
+  out[0] = vtkTiledSquirtMagic;
+  out[1] = static_cast<unsigned int>(numComps);
+  out[2] = static_cast<unsigned int>(numPixels);
+  out[3] = static_cast<unsigned int>(tileSize);
+  out[4] = static_cast<unsigned int>(numTiles);
+  vtkIdType packedEnd = headerWords;
+  for (vtkIdType tile = 0; tile < numTiles; ++tile)
+  {
+    out[vtkTiledSquirtHeaderWords + tile] = static_cast<unsigned int>(encodedSizes[tile]);
+    const vtkIdType slot = headerWords + tile * tileSize;
+    if (packedEnd != slot)
+    {
+      memmove(out + packedEnd, out + slot, encodedSizes[tile] * sizeof(unsigned int));
+    }
+    packedEnd += encodedSizes[tile];
+  }
+
+  this->Output->SetNumberOfTuples(4 * packedEnd);
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+int vtkTiledSquirtCompressor::Decompress()
+{
+  if (!(this->Input && this->Output))
+  {
+    vtkWarningMacro("Cannot decompress empty input or output detected.");
+    return VTK_ERROR;
+  }
+
+  vtkUnsignedCharArray* in = this->GetInput();
+  vtkUnsignedCharArray* out = this->GetOutput();
+  const vtkIdType numWords = in->GetNumberOfTuples() * in->GetNumberOfComponents() / 4;
+  const unsigned int* words = reinterpret_cast<const unsigned int*>(in->GetPointer(0));
+  if (numWords < vtkTiledSquirtHeaderWords || words[0] != vtkTiledSquirtMagic)
+  {
+    vtkErrorMacro("Input was not compressed with vtkTiledSquirtCompressor.");
+    return VTK_ERROR;
+  }
+
+  const int numComps = static_cast<int>(words[1]);
+  const vtkIdType numPixels = static_cast<vtkIdType>(words[2]);
+  const vtkIdType tileSize = static_cast<vtkIdType>(words[3]);
+  const vtkIdType numTiles = static_cast<vtkIdType>(words[4]);
+  const vtkIdType headerWords = vtkTiledSquirtHeaderWords + numTiles;
+  if (numComps != out->GetNumberOfComponents() || numPixels != out->GetNumberOfTuples() ||
+    tileSize <= 0 || numTiles != (numPixels + tileSize - 1) / tileSize || headerWords > numWords)
+  {
+    vtkErrorMacro("Compressed stream does not match the output array.");
+    return VTK_ERROR;
+  }
+
+  std::vector<vtkIdType> offsets(numTiles + 1, 0);
+  for (vtkIdType tile = 0; tile < numTiles; ++tile)
+  {
+    offsets[tile + 1] = offsets[tile] + words[vtkTiledSquirtHeaderWords + tile];
+  }
+  if (headerWords + offsets[numTiles] > numWords)
+  {
+    vtkErrorMacro("Compressed stream is truncated.");
+    return VTK_ERROR;
+  }
+
+  std::vector<unsigned char> status(numTiles, 0);
+  vtkTiledSquirtDecodeFunctor functor;
+  functor.Input = words + headerWords;
+  functor.Offsets = &offsets;
+  functor.NumberOfComponents = numComps;
+  functor.NumberOfPixels = numPixels;
+  functor.TileSize = tileSize;
+  functor.Output = out->GetPointer(0);
+  functor.Status = &status;
+  vtkSMPTools::For(0, numTiles, 1, functor);
+
+  if (std::find(status.begin(), status.end(), 0) != status.end())
+  {
+    vtkErrorMacro("Corrupt tile in compressed stream.");
+    return VTK_ERROR;
+  }
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTiledSquirtCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "TileSize: " << this->TileSize << endl;
+}
@@ -0,0 +1,77 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTiledSquirtCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkTiledSquirtCompressor
+ * @brief   multithreaded SQUIRT image compressor.
+ *
+ * vtkTiledSquirtCompressor uses the same run-length encoding and color masks
+ * as vtkSquirtCompressor, but splits the image into tiles of TileSize pixels
+ * that are encoded and decoded independently and in parallel using
+ * vtkSMPTools. Runs never cross tile boundaries.
+ *
+ * The compressed stream starts with a header giving the number of tiles and
+ * the size of each encoded tile, so the decompressor can locate every tile
+ * up front and decode them concurrently. The stream is therefore not
+ * compatible with vtkSquirtCompressor; both ends of a connection must use
+ * vtkTiledSquirtCompressor.
+ *
+ * @sa vtkSquirtCompressor
+*/
+
+#ifndef vtkTiledSquirtCompressor_h
+#define vtkTiledSquirtCompressor_h
+
+#include "vtkPVVTKExtensionsRenderingModule.h" // needed for export macro
+#include "vtkSquirtCompressor.h"
+
+class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkTiledSquirtCompressor : public vtkSquirtCompressor
+{
+public:
+  static vtkTiledSquirtCompressor* New();
+  vtkTypeMacro(vtkTiledSquirtCompressor, vtkSquirtCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Number of pixels per tile. Smaller tiles expose more parallelism at the
+   * cost of slightly worse compression, since runs are broken at tile
+   * boundaries. This only affects the compressor; the decompressor reads the
+   * tile size from the stream. Default is 65536.
+   */
+  vtkSetClampMacro(TileSize, int, 256, VTK_INT_MAX);
+  vtkGetMacro(TileSize, int);
+  //@}
+
+  //@{
+  /**
+   * Compress/Decompress data array on the objects input with results
+   * in the objects output. See also Set/GetInput/Output.
+   */
+  int Compress() VTK_OVERRIDE;
+  int Decompress() VTK_OVERRIDE;
+  //@}
+
+protected:
+  vtkTiledSquirtCompressor();
+  ~vtkTiledSquirtCompressor() override;
+
+  int TileSize;
+
+private:
+  vtkTiledSquirtCompressor(const vtkTiledSquirtCompressor&) = delete;
+  void operator=(const vtkTiledSquirtCompressor&) = delete;
+};
+
+#endif
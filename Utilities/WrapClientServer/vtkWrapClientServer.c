@@ -428,8 +428,8 @@ void outputFunction(FILE* fp, ClassInfo* data)
     {
       fprintf(fp, "#if !defined(VTK_LEGACY_REMOVE)\n");
     }
-    fprintf(fp, "  if (!strcmp(\"%s\",method) && msg.GetNumberOfArguments(0) == %i)\n",
-      currentFunction->Name, currentFunction->NumberOfArguments + 2);
+    /* the case index must match the one emitted by output_MethodTable */
+    fprintf(fp, "    case %i:\n", numberOfWrappedFunctions);
     fprintf(fp, "    {\n");
 
     /* process the args */
@@ -495,6 +495,7 @@ void outputFunction(FILE* fp, ClassInfo* data)
     fprintf(fp, "      return 1;\n");
     fprintf(fp, "      }\n");
     fprintf(fp, "    }\n");
+    fprintf(fp, "    break;\n");
     if (currentFunction->IsLegacy)
     {
       fprintf(fp, "#endif\n");
@@ -1127,6 +1128,106 @@ void output_InitFunction(FILE* fp, NewClassInfo* data)
   fprintf(fp, "    }\n}\n");
 }
 
+//--------------------------------------------------------------------------nix
+/*
+ * This structure holds one entry of the method table emitted for a class.
+ *
+ */
+typedef struct _MethodTableEntry
+{
+  const char* Name;
+  int NumberOfArguments;
+  int Index;
+  int IsLegacy;
+} MethodTableEntry;
+
+//--------------------------------------------------------------------------nix
+/*
+ * methodEntryCmp orders method table entries by name, then by number of
+ * arguments, then by declaration order. The first two keys must match the
+ * order used by vtkClientServerInterpreter::FindMethod.
+ */
+int methodEntryCmp(const void* entry1, const void* entry2)
+{
+  const MethodTableEntry* a = (const MethodTableEntry*)entry1;
+  const MethodTableEntry* b = (const MethodTableEntry*)entry2;
+  int cmp = strcmp(a->Name, b->Name);
+  if (cmp == 0)
+  {
+    cmp = a->NumberOfArguments - b->NumberOfArguments;
+  }
+  if (cmp == 0)
+  {
+    cmp = a->Index - b->Index;
+  }
+  return cmp;
+}
+
+//--------------------------------------------------------------------------nix
+/*
+ * output_MethodTable writes a table of the wrapped methods of the class
+ * sorted by name and number of arguments, followed by the head of the loop
+ * that looks up the invoked method in it and switches to the code for each
+ * matching overload. The indices are assigned in the same order as
+ * outputFunction assigns its case labels.
+ *
+ * @param fp file to write into
+ * @param data class being wrapped
+ */
+void output_MethodTable(FILE* fp, ClassInfo* data)
+{
+  FunctionInfo** functions;
+  MethodTableEntry* entries;
+  int numberOfEntries;
+  int i;
+
+  functions = (FunctionInfo**)malloc(sizeof(FunctionInfo*) * (data->NumberOfFunctions + 1));
+  entries = (MethodTableEntry*)malloc(sizeof(MethodTableEntry) * (data->NumberOfFunctions + 1));
+  numberOfEntries =
+    extractWrappable(data->Functions, data->NumberOfFunctions, functions, data->Name);
+  for (i = 0; i < numberOfEntries; i++)
+  {
+    entries[i].Name = functions[i]->Name;
+    entries[i].NumberOfArguments = functions[i]->NumberOfArguments + 2;
+    entries[i].Index = i;
+    entries[i].IsLegacy = functions[i]->IsLegacy;
+  }
+  qsort(entries, numberOfEntries, sizeof(MethodTableEntry), methodEntryCmp);
+
+  /* The leading empty entry sorts first and keeps the table non-empty. */
+  fprintf(fp, "  static const vtkClientServerMethodEntry methods[] = {\n"
+              "    { \"\", 0, -1 },\n");
+  for (i = 0; i < numberOfEntries; i++)
+  {
+    if (entries[i].IsLegacy)
+    {
+      fprintf(fp, "#if !defined(VTK_LEGACY_REMOVE)\n");
+    }
+    fprintf(fp, "    { \"%s\", %i, %i },\n", entries[i].Name, entries[i].NumberOfArguments,
+      entries[i].Index);
+    if (entries[i].IsLegacy)
+    {
+      fprintf(fp, "#endif\n");
+    }
+  }
+  fprintf(fp, "  };\n"
+              "  const vtkClientServerMethodEntry* methodsEnd =\n"
+              "    methods + sizeof(methods) / sizeof(methods[0]);\n"
+              "  const int numberOfArguments = msg.GetNumberOfArguments(0);\n"
+              "  for (const vtkClientServerMethodEntry* entry =\n"
+              "         vtkClientServerInterpreter::FindMethod(\n"
+              "           methods, methodsEnd, method, numberOfArguments);\n"
+              "       entry != methodsEnd && entry->NumberOfArguments == numberOfArguments &&\n"
+              "       !strcmp(entry->Name, method);\n"
+              "       ++entry)\n"
+              "  {\n"
+              "    switch (entry->Index)\n"
+              "    {\n");
+
+  free(entries);
+  free(functions);
+}
+
 /* check all methods for use of vtkStdString */
 int classUsesStdString(ClassInfo* data)
 {
@@ -1331,12 +1432,17 @@ int main(int argc, char* argv[])
 
   /*fprintf(fp,"  vtkClientServerStream resultStream;\n");*/
 
-  /* insert function handling code here */
+  /* insert function handling code here, dispatched through a sorted table */
+  output_MethodTable(fp, data);
   for (i = 0; i < data->NumberOfFunctions; i++)
   {
     currentFunction = data->Functions[i];
     outputFunction(fp, data);
   }
+  fprintf(fp, "    default:\n"
+              "      break;\n"
+              "    }\n"
+              "  }\n");
 
   /* try superclasses */
   for (i = 0; i < data->NumberOfSuperClasses; i++)
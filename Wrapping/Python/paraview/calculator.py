@@ -12,6 +12,7 @@ except ImportError:
 import paraview
 from paraview import vtk
 import vtk.numpy_interface.dataset_adapter as dsa
+import vtk.util.numpy_support as numpy_support
 from vtk.numpy_interface.algorithms import *
     # -- this will import vtkMultiProcessController and vtkMPI4PyCommunicator
 import sys
@@ -166,12 +167,16 @@ def get_data_time(self, do, ininfo):
             pass
     return (t, t_index)
 
-def execute(self, expression):
+def execute(self, expression, state=None):
     """
     **Internal Method**
     Called by vtkPythonCalculator in its RequestData(...) method. This is not
     intended for use externally except from within
     vtkPythonCalculator::RequestData(...).
+
+    When `state` is given (see execute_persistent()), its compiled expression,
+    wrapped inputs and arrays are used instead of `expression`, and updated as
+    needed.
     """
 
     # Add inputs.
@@ -179,11 +184,17 @@ def execute(self, expression):
 
     for index in range(self.GetNumberOfInputConnections(0)):
         # wrap all input data objects using vtk.numpy_interface.dataset_adapter
-        wdo_input = dsa.WrapDataObject(self.GetInputDataObject(0, index))
-        t, t_index = get_data_time(self, wdo_input.VTKObject, self.GetInputInformation(0, index))
+        do = self.GetInputDataObject(0, index)
+        if state is not None:
+            wdo_input = state.wrap_input(index, do)
+        else:
+            wdo_input = dsa.WrapDataObject(do)
+        t, t_index = get_data_time(self, do, self.GetInputInformation(0, index))
         wdo_input.time_value = wdo_input.t_value = t
         wdo_input.time_index = wdo_input.t_index = t_index
         inputs.append(wdo_input)
+    if state is not None:
+        del state.inputs[len(inputs):]
 
     # Setup output.
     output = dsa.WrapDataObject(self.GetOutputDataObject(0))
@@ -194,13 +205,19 @@ def execute(self, expression):
 
     # get a dictionary for arrays in the dataset attributes. We pass that
     # as the variables in the eval namespace for compute.
-    variables = get_arrays(inputs[0].GetAttributes(self.GetArrayAssociation()))
+    if state is not None:
+        variables = state.get_arrays(inputs[0], self.GetArrayAssociation())
+        expression = state.code
+    else:
+        variables = get_arrays(inputs[0].GetAttributes(self.GetArrayAssociation()))
     variables.update({ "time_value": inputs[0].time_value,
                        "t_value": inputs[0].t_value,
                        "time_index": inputs[0].time_index,
                        "t_index": inputs[0].t_index })
     retVal = compute(inputs, expression, ns=variables)
     if retVal is not None:
+        if state is not None and _append_shared_result(self, output, retVal):
+            return
         if hasattr(retVal, "Association"):
             output.GetAttributes(retVal.Association).append(\
               retVal, self.GetArrayName())
@@ -209,3 +226,111 @@ def execute(self, expression):
             # fall back to the input array association
             output.GetAttributes(self.GetArrayAssociation()).append(\
               retVal, self.GetArrayName())
+
+def _get_mtime(do):
+    """Returns the MTime of a data object. For composite datasets, this
+    includes the MTime of the leaves, which can be modified without modifying
+    the composite dataset."""
+    mtime = do.GetMTime()
+    if do.IsA("vtkCompositeDataSet"):
+        iterator = do.NewIterator()
+        iterator.InitTraversal()
+        while not iterator.IsDoneWithTraversal():
+            mtime = max(mtime, iterator.GetCurrentDataObject().GetMTime())
+            iterator.GoToNextItem()
+    return mtime
+
+def _is_parallel(controller=None):
+    if controller is None and vtkMultiProcessController is not None:
+        controller = vtkMultiProcessController.GetGlobalController()
+    return controller is not None and controller.GetNumberOfProcesses() > 1
+
+class _PersistentState(object):
+    """State kept between executions of a vtkPythonCalculator with
+    PersistentState on. See execute_persistent().
+
+    The wrapped inputs and the arrays of the first input are reused as long as
+    the input data objects are the same and their MTime, which includes the
+    leaves of composite datasets, did not change. They hold references to the
+    inputs until the next execution or release_state()."""
+    def __init__(self):
+        self.expression = None
+        self.code = None
+        # per input connection: [data object, MTime, wrapped data object]
+        self.inputs = []
+        self.arrays = None
+        self.arrays_key = None
+
+    def wrap_input(self, index, do):
+        mtime = _get_mtime(do)
+        if index < len(self.inputs):
+            entry = self.inputs[index]
+            if entry[0] is do and entry[1] == mtime:
+                return entry[2]
+            entry[:] = [do, mtime, dsa.WrapDataObject(do)]
+        else:
+            entry = [do, mtime, dsa.WrapDataObject(do)]
+            self.inputs.append(entry)
+        return entry[2]
+
+    def get_arrays(self, wdo_input, association):
+        # In parallel get_arrays() is collective, so it is always called.
+        key = (self.inputs[0][0], self.inputs[0][1], association)
+        if self.arrays is None or self.arrays_key != key or _is_parallel():
+            self.arrays = get_arrays(wdo_input.GetAttributes(association))
+            self.arrays_key = key
+        return dict(self.arrays)
+
+# persistent states, keyed on the address of the vtkPythonCalculator.
+_persistent_states = dict()
+
+def release_state(key):
+    """
+    **Internal Method**
+    Called by the vtkPythonCalculator destructor to release the state created
+    by execute_persistent().
+    """
+    _persistent_states.pop(key, None)
+
+def _data_address(array):
+    return array.__array_interface__["data"][0]
+
+def _append_shared_result(self, output, retVal):
+    """A result that is a whole VTK array (e.g. an input array returned as is)
+    is added as a shallow copy of that array instead of being converted from
+    numpy. Returns False if the result is anything else."""
+    vtkarray = getattr(retVal, "VTKObject", None)
+    if not isinstance(retVal, dsa.VTKArray) or vtkarray is None or \
+        retVal.size == 0 or not retVal.flags.contiguous:
+        return False
+    data = numpy_support.vtk_to_numpy(vtkarray)
+    if retVal.shape != data.shape or retVal.dtype != data.dtype or \
+        _data_address(retVal) != _data_address(data):
+        return False
+
+    if hasattr(retVal, "Association"):
+        association = retVal.Association
+    else:
+        association = self.GetArrayAssociation()
+    array = vtkarray.NewInstance()
+    array.ShallowCopy(vtkarray)
+    array.SetName(self.GetArrayName())
+    output.GetAttributes(association).VTKObject.AddArray(array)
+    return True
+
+def execute_persistent(self, expression, key):
+    """
+    **Internal Method**
+    Same as execute(), for vtkPythonCalculator with PersistentState on. The
+    compiled expression, the wrapped inputs and the arrays of the first input
+    are kept, keyed on `key`, until release_state() is called.
+    """
+    state = _persistent_states.get(key)
+    if state is None:
+        state = _PersistentState()
+        _persistent_states[key] = state
+
+    if state.expression != expression:
+        state.code = compile(expression, "<vtkPythonCalculator>", "eval")
+        state.expression = expression
+    execute(self, expression, state)